@@ -76,6 +76,15 @@ void performance_profile(int rep_time, Functor func, Param& m)
 		func(m.begin(), m.end());
 }
 
+template<class Param>
+void performance_profile(int rep_time, cursor_iteration_tmap func, Param& m)
+{
+	infos(rep_time, func, vs, m);
+	boost::timer::auto_cpu_timer t(5, " %t sec CPU, %w sec real\n\n");
+	for (int i = 0; i < rep_time; ++i)
+		func(m);
+}
+
 
 int main()
 {
@@ -93,8 +102,10 @@ int main()
 	performance_profile(100, count_prefix_from_tmap(), vs[0], tm);
 	performance_profile(1, handle_prefixes(), count_prefix_from_map(), vs, m);
 	performance_profile(1, handle_prefixes(), count_prefix_from_tmap(), vs, tm);
+	performance_profile(1, count_prefix_sorted_batch_tmap(), vs, tm);
 	performance_profile(100, iteration(), m);
 	performance_profile(100, iteration(), tm);
+	performance_profile(100, cursor_iteration_tmap(), tm);
 
 	return 0;
 }
@@ -74,6 +74,29 @@ class count_prefix_from_tmap{
 			}
 };
 
+class count_prefix_sorted_batch_tmap{
+	public:
+		template<class Key, class KeyElement>
+			void operator()(std::vector<Key>& a, boost::tries::trie_map<KeyElement, int>& t)
+			{
+				std::vector<size_t> counts;
+				counts.reserve(a.size());
+				t.count_prefix_sorted_batch(a.begin(), a.end(), std::back_inserter(counts));
+				assert(counts.size() == a.size());
+			}
+};
+
+class cursor_iteration_tmap{
+	public:
+		template<class KeyElement>
+			void operator()(boost::tries::trie_map<KeyElement, int>& t)
+			{
+				typename boost::tries::trie_map<KeyElement, int>::cursor c = t.begin_cursor();
+				for (; !c.at_end(); ++c)
+					c.key();
+			}
+};
+
 
 //clear
 //swap
@@ -0,0 +1,292 @@
+#ifndef BOOST_AHO_CORASICK_MATCHER
+#define BOOST_AHO_CORASICK_MATCHER
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <vector>
+#include <algorithm>
+#include <boost/cstdint.hpp>
+#include <boost/trie/trie_set.hpp>
+#include <boost/trie/trie_map.hpp>
+
+namespace boost { namespace tries {
+
+/*
+ * Aho-Corasick automaton over the keys of a trie_set or trie_map, for
+ * finding every occurrence of every key in a text in O(text *
+ * log(alphabet) + matches): each transition is a binary search over the
+ * edges of a state, and following failure links costs at most one more
+ * transition per element of the text, amortized.
+ *
+ * States are the nodes of the trie numbered in breadth first order; the
+ * edges of a state are stored sorted and contiguous, so the automaton is
+ * about as big as the trie. Each state has a failure link, to the state
+ * of its longest proper suffix that is also in the trie, and an output
+ * link, to the nearest state along the failure links that ends a key.
+ * Keys are numbered by their rank in the trie, which is what a match
+ * reports with its position and length. The empty key never matches.
+ */
+template<typename Key>
+class aho_corasick_matcher
+{
+public:
+	typedef Key key_type;
+	typedef size_t size_type;
+	typedef boost::uint32_t state_type;
+
+	struct match_type {
+		// offset of the first element of the occurrence in the text
+		size_type position;
+		size_type length;
+		// rank of the key among the keys of the trie
+		size_type pattern;
+	};
+
+	// where a scan stopped; pass it to the next scan to go on with a stream
+	struct scan_state {
+		state_type state;
+		size_type offset;
+
+		scan_state() : state(0), offset(0)
+		{
+		}
+	};
+
+private:
+	static const state_type no_state = static_cast<state_type>(-1);
+
+	// edges of state s are [first_edge[s], first_edge[s + 1])
+	std::vector<state_type> first_edge;
+	std::vector<key_type> edge_keys;
+	std::vector<state_type> edge_targets;
+	std::vector<state_type> fail;
+	std::vector<state_type> output;
+	std::vector<state_type> depth;
+	// rank of the key ending at a state, no_state if none does
+	std::vector<state_type> pattern_id;
+	size_type pattern_count;
+
+	struct build_frame {
+		size_type lo, hi;
+		state_type depth;
+	};
+
+	static bool key_equal(const key_type& a, const key_type& b)
+	{
+		return !(a < b) && !(b < a);
+	}
+
+	// the edge of s labelled key, by binary search, or no_state
+	state_type go(state_type s, const key_type& key) const
+	{
+		typename std::vector<key_type>::const_iterator first = edge_keys.begin() + first_edge[s];
+		typename std::vector<key_type>::const_iterator last = edge_keys.begin() + first_edge[s + 1];
+		typename std::vector<key_type>::const_iterator it = std::lower_bound(first, last, key);
+		if (it == last || key < *it)
+			return no_state;
+		return edge_targets[it - edge_keys.begin()];
+	}
+
+	state_type add_state(state_type d, state_type pattern)
+	{
+		depth.push_back(d);
+		pattern_id.push_back(pattern);
+		return static_cast<state_type>(depth.size() - 1);
+	}
+
+	void build(const std::vector<std::vector<key_type> >& keys)
+	{
+		first_edge.clear();
+		edge_keys.clear();
+		edge_targets.clear();
+		depth.clear();
+		pattern_id.clear();
+		pattern_count = keys.size();
+
+		// the goto trie, states numbered in the order they are queued
+		std::vector<build_frame> frames;
+		build_frame root = { 0, keys.size(), 0 };
+		frames.push_back(root);
+		add_state(0, no_state);
+		for (size_type s = 0; s < frames.size(); ++s)
+		{
+			build_frame f = frames[s];
+			size_type lo = f.lo;
+			if (lo < f.hi && keys[lo].size() == f.depth)
+				++lo;
+			first_edge.push_back(static_cast<state_type>(edge_keys.size()));
+			while (lo < f.hi)
+			{
+				size_type hi = lo + 1;
+				while (hi < f.hi && key_equal(keys[hi][f.depth], keys[lo][f.depth]))
+					++hi;
+				state_type d = f.depth + 1;
+				state_type child = add_state(d,
+					keys[lo].size() == d ? static_cast<state_type>(lo) : no_state);
+				edge_keys.push_back(keys[lo][f.depth]);
+				edge_targets.push_back(child);
+				build_frame cf = { lo, hi, d };
+				frames.push_back(cf);
+				lo = hi;
+			}
+		}
+		first_edge.push_back(static_cast<state_type>(edge_keys.size()));
+
+		// failure and output links; a parent always comes before its children
+		fail.assign(depth.size(), 0);
+		output.assign(depth.size(), no_state);
+		for (state_type s = 0; s < depth.size(); ++s)
+		{
+			for (state_type e = first_edge[s]; e < first_edge[s + 1]; ++e)
+			{
+				state_type t = edge_targets[e];
+				if (s != 0)
+				{
+					state_type f = fail[s];
+					state_type next = go(f, edge_keys[e]);
+					while (next == no_state && f != 0)
+					{
+						f = fail[f];
+						next = go(f, edge_keys[e]);
+					}
+					fail[t] = next == no_state ? 0 : next;
+				}
+				state_type ft = fail[t];
+				output[t] = ft != 0 && pattern_id[ft] != no_state ? ft : output[ft];
+			}
+		}
+		std::vector<key_type>(edge_keys).swap(edge_keys);
+	}
+
+public:
+	explicit aho_corasick_matcher() : pattern_count(0)
+	{
+		build(std::vector<std::vector<key_type> >());
+	}
+
+	template<typename ChildPolicy, typename Allocator>
+	explicit aho_corasick_matcher(const trie_set<Key, ChildPolicy, Allocator>& other) : pattern_count(0)
+	{
+		build_from(other);
+	}
+
+	template<typename Value, typename ChildPolicy, typename Allocator>
+	explicit aho_corasick_matcher(const trie_map<Key, Value, ChildPolicy, Allocator>& other) : pattern_count(0)
+	{
+		build_from(other);
+	}
+
+	// rebuild from the keys of a trie, replacing the current automaton
+	template<typename ChildPolicy, typename Allocator>
+	void build_from(const trie_set<Key, ChildPolicy, Allocator>& other)
+	{
+		typedef typename trie_set<Key, ChildPolicy, Allocator>::const_iterator source_iterator;
+		std::vector<std::vector<key_type> > keys;
+		keys.reserve(other.size());
+		for (source_iterator it = other.begin(); it != other.end(); ++it)
+			keys.push_back(*it);
+		build(keys);
+	}
+
+	template<typename Value, typename ChildPolicy, typename Allocator>
+	void build_from(const trie_map<Key, Value, ChildPolicy, Allocator>& other)
+	{
+		typedef typename trie_map<Key, Value, ChildPolicy, Allocator>::const_iterator source_iterator;
+		std::vector<std::vector<key_type> > keys;
+		keys.reserve(other.size());
+		for (source_iterator it = other.begin(); it != other.end(); ++it)
+			keys.push_back(it.get_key());
+		build(keys);
+	}
+
+	/*
+	 * Feed [first, last) to the automaton and call f(match) for every key
+	 * occurrence ending in it, in order of the end position. Positions
+	 * count from the start of the stream state describes, so a text split
+	 * over several buffers reports the same matches as the whole text.
+	 */
+	template<typename Iter, typename Function>
+	Function scan(Iter first, Iter last, Function f, scan_state& state) const
+	{
+		state_type s = state.state;
+		size_type offset = state.offset;
+		for (; first != last; ++first)
+		{
+			++offset;
+			state_type next = go(s, *first);
+			while (next == no_state && s != 0)
+			{
+				s = fail[s];
+				next = go(s, *first);
+			}
+			s = next == no_state ? 0 : next;
+			state_type u = pattern_id[s] != no_state ? s : output[s];
+			for (; u != no_state; u = output[u])
+			{
+				match_type m = { offset - depth[u], depth[u], pattern_id[u] };
+				f(m);
+			}
+		}
+		state.state = s;
+		state.offset = offset;
+		return f;
+	}
+
+	template<typename Iter, typename Function>
+	Function scan(Iter first, Iter last, Function f) const
+	{
+		scan_state state;
+		return scan(first, last, f, state);
+	}
+
+	template<typename Container, typename Function>
+	Function scan(const Container& container, Function f) const
+	{
+		return scan(container.begin(), container.end(), f);
+	}
+
+	template<typename Container, typename Function>
+	Function scan(const Container& container, Function f, scan_state& state) const
+	{
+		return scan(container.begin(), container.end(), f, state);
+	}
+
+	// number of keys
+	size_type size() const
+	{
+		return pattern_count;
+	}
+
+	bool empty() const
+	{
+		return pattern_count == 0;
+	}
+
+	// states other than the root
+	size_type count_node() const
+	{
+		return depth.size() - 1;
+	}
+};
+
+template<typename Key>
+const typename aho_corasick_matcher<Key>::state_type aho_corasick_matcher<Key>::no_state;
+
+// an automaton matching the keys of t
+template<typename Key, typename ChildPolicy, typename Allocator>
+aho_corasick_matcher<Key> build_matcher(const trie_set<Key, ChildPolicy, Allocator>& t)
+{
+	return aho_corasick_matcher<Key>(t);
+}
+
+template<typename Key, typename Value, typename ChildPolicy, typename Allocator>
+aho_corasick_matcher<Key> build_matcher(const trie_map<Key, Value, ChildPolicy, Allocator>& t)
+{
+	return aho_corasick_matcher<Key>(t);
+}
+
+}	// namespace tries
+}	// namespace boost
+#endif
@@ -0,0 +1,149 @@
+#ifndef BOOST_TRIE_ARENA_ALLOCATOR_HPP
+#define BOOST_TRIE_ARENA_ALLOCATOR_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <cstddef>
+#include <boost/type_traits/alignment_of.hpp>
+#include <boost/trie/detail/node_arena.hpp>
+
+namespace boost { namespace tries {
+
+/*
+ * Allocator bump allocating from a node_arena. deallocate() does nothing,
+ * memory comes back when the arena is released. A trie whose allocator is
+ * an arena_allocator, and which holds every live copy of it, drops all of
+ * its nodes at once in clear() and in its destructor; for keys and values
+ * with trivial destructors the nodes are not even visited. While another
+ * copy is alive, be it another trie, any other container or the
+ * allocator the trie was built from, the trie erases node by node and
+ * leaves the arena alone; call release_arena() on the trie to drop it
+ * all the same once nothing else uses the arena.
+ *
+ * Copies share the arena, except the copy made for a copied trie, which
+ * gets a fresh arena of the same chunk size.
+ */
+template <typename T>
+class arena_allocator
+{
+public:
+	typedef T value_type;
+	typedef T* pointer;
+	typedef const T* const_pointer;
+	typedef T& reference;
+	typedef const T& const_reference;
+	typedef std::size_t size_type;
+	typedef std::ptrdiff_t difference_type;
+
+	enum { default_chunk_size = 64 * 1024 };
+
+	template <typename U>
+	struct rebind {
+		typedef arena_allocator<U> other;
+	};
+
+private:
+	template <typename U> friend class arena_allocator;
+	template <typename Alloc> friend struct detail::arena_hooks;
+
+	detail::node_arena *arena;
+
+	void release_ref()
+	{
+		if (arena->remove_ref())
+			delete arena;
+	}
+
+public:
+	explicit arena_allocator(size_type chunk_size = default_chunk_size) :
+		arena(new detail::node_arena(chunk_size))
+	{
+		arena->add_ref();
+	}
+
+	arena_allocator(const arena_allocator& other) : arena(other.arena)
+	{
+		arena->add_ref();
+	}
+
+	template <typename U>
+	arena_allocator(const arena_allocator<U>& other) : arena(other.arena)
+	{
+		arena->add_ref();
+	}
+
+	arena_allocator& operator=(const arena_allocator& other)
+	{
+		other.arena->add_ref();
+		release_ref();
+		arena = other.arena;
+		return *this;
+	}
+
+	~arena_allocator()
+	{
+		release_ref();
+	}
+
+	pointer allocate(size_type n)
+	{
+		return static_cast<pointer>(arena->allocate(n * sizeof(T),
+			boost::alignment_of<T>::value));
+	}
+
+	void deallocate(pointer, size_type)
+	{
+	}
+
+	arena_allocator select_on_container_copy_construction() const
+	{
+		return arena_allocator(arena->get_chunk_size());
+	}
+
+	size_type chunk_count() const
+	{
+		return arena->chunk_count();
+	}
+
+	size_type bytes_used() const
+	{
+		return arena->bytes_used();
+	}
+
+	template <typename U>
+	bool operator==(const arena_allocator<U>& other) const
+	{
+		return arena == other.arena;
+	}
+
+	template <typename U>
+	bool operator!=(const arena_allocator<U>& other) const
+	{
+		return arena != other.arena;
+	}
+};
+
+namespace detail {
+
+template <typename T>
+struct arena_hooks<arena_allocator<T> > {
+	enum { is_arena = true };
+
+	static bool sole_owner(const arena_allocator<T>& alloc, std::size_t held)
+	{
+		return alloc.arena->ref_count() == held;
+	}
+
+	static void release(arena_allocator<T>& alloc)
+	{
+		alloc.arena->release();
+	}
+};
+
+} /* detail */
+} /* tries */
+} /* boost */
+
+#endif
@@ -0,0 +1,227 @@
+#ifndef BOOST_TRIE_BYTE_SEARCH_HPP
+#define BOOST_TRIE_BYTE_SEARCH_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <cstddef>
+#include <boost/cstdint.hpp>
+
+/*
+ * Vector search over the key bytes of the adaptive child containers.
+ * SSE2 is used when the target has it, AVX2 widens the scans of the
+ * 256 entry index to 32 bytes at a time. Define BOOST_TRIE_NO_SIMD to
+ * force the scalar code.
+ */
+#if !defined(BOOST_TRIE_NO_SIMD)
+#  if defined(__AVX2__)
+#    define BOOST_TRIE_HAS_AVX2
+#  endif
+#  if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define BOOST_TRIE_HAS_SSE2
+#  endif
+#endif
+
+#if defined(BOOST_TRIE_HAS_AVX2)
+#include <immintrin.h>
+#elif defined(BOOST_TRIE_HAS_SSE2)
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace boost { namespace tries {
+
+namespace detail {
+
+// index of the lowest set bit, x must not be 0
+inline int lowest_bit(boost::uint32_t x)
+{
+#if defined(__GNUC__)
+	return __builtin_ctz(x);
+#elif defined(_MSC_VER)
+	unsigned long i;
+	_BitScanForward(&i, x);
+	return static_cast<int>(i);
+#else
+	int i = 0;
+	for (; !(x & 1); x >>= 1)
+		++i;
+	return i;
+#endif
+}
+
+// index of the highest set bit, x must not be 0
+inline int highest_bit(boost::uint32_t x)
+{
+#if defined(__GNUC__)
+	return 31 - __builtin_clz(x);
+#elif defined(_MSC_VER)
+	unsigned long i;
+	_BitScanReverse(&i, x);
+	return static_cast<int>(i);
+#else
+	int i = 31;
+	for (; !(x & 0x80000000u); x <<= 1)
+		--i;
+	return i;
+#endif
+}
+
+inline int bit_count(boost::uint32_t x)
+{
+#if defined(__GNUC__)
+	return __builtin_popcount(x);
+#else
+	x = x - ((x >> 1) & 0x55555555u);
+	x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+	return static_cast<int>((((x + (x >> 4)) & 0x0f0f0f0fu) * 0x01010101u) >> 24);
+#endif
+}
+
+#if defined(BOOST_TRIE_HAS_SSE2)
+// bit i is set when keys[i] < b, comparing as unsigned bytes
+inline boost::uint32_t less_mask16(const unsigned char *keys, unsigned char b)
+{
+	const __m128i bias = _mm_set1_epi8(static_cast<char>(0x80));
+	__m128i k = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys)), bias);
+	__m128i v = _mm_xor_si128(_mm_set1_epi8(static_cast<char>(b)), bias);
+	return static_cast<boost::uint32_t>(_mm_movemask_epi8(_mm_cmplt_epi8(k, v)));
+}
+
+// bit i is set when keys[i] > b
+inline boost::uint32_t greater_mask16(const unsigned char *keys, unsigned char b)
+{
+	const __m128i bias = _mm_set1_epi8(static_cast<char>(0x80));
+	__m128i k = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys)), bias);
+	__m128i v = _mm_xor_si128(_mm_set1_epi8(static_cast<char>(b)), bias);
+	return static_cast<boost::uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(k, v)));
+}
+#endif
+
+/*
+ * Position of the first of the n sorted keys that is not less than b.
+ * The 16 bytes at keys must be readable, whatever n is.
+ */
+inline std::size_t sorted16_lower_index(const unsigned char *keys, std::size_t n, unsigned char b)
+{
+#if defined(BOOST_TRIE_HAS_SSE2)
+	return bit_count(less_mask16(keys, b) & ((1u << n) - 1));
+#else
+	std::size_t i = 0;
+	while (i < n && keys[i] < b)
+		++i;
+	return i;
+#endif
+}
+
+// position of the first of the n sorted keys that is greater than b
+inline std::size_t sorted16_upper_index(const unsigned char *keys, std::size_t n, unsigned char b)
+{
+#if defined(BOOST_TRIE_HAS_SSE2)
+	return n - bit_count(greater_mask16(keys, b) & ((1u << n) - 1));
+#else
+	std::size_t i = 0;
+	while (i < n && keys[i] <= b)
+		++i;
+	return i;
+#endif
+}
+
+#if defined(BOOST_TRIE_HAS_AVX2)
+static const int byte_scan_width = 32;
+
+inline boost::uint32_t nonzero_mask(const unsigned char *bytes)
+{
+	__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes));
+	return ~static_cast<boost::uint32_t>(_mm256_movemask_epi8(
+		_mm256_cmpeq_epi8(v, _mm256_setzero_si256())));
+}
+#elif defined(BOOST_TRIE_HAS_SSE2)
+static const int byte_scan_width = 16;
+
+inline boost::uint32_t nonzero_mask(const unsigned char *bytes)
+{
+	__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+	return ~static_cast<boost::uint32_t>(_mm_movemask_epi8(
+		_mm_cmpeq_epi8(v, _mm_setzero_si128()))) & 0xffffu;
+}
+#endif
+
+// first of the 256 bytes at or after from that is not 0, -1 if none
+inline int first_nonzero_byte(const unsigned char *bytes, int from)
+{
+#if defined(BOOST_TRIE_HAS_SSE2)
+	for (int start = from & ~(byte_scan_width - 1); start < 256; start += byte_scan_width)
+	{
+		boost::uint32_t mask = nonzero_mask(bytes + start);
+		if (start < from)
+			mask &= ~0u << (from - start);
+		if (mask)
+			return start + lowest_bit(mask);
+	}
+#else
+	for (int b = from; b < 256; ++b)
+		if (bytes[b])
+			return b;
+#endif
+	return -1;
+}
+
+// last of the 256 bytes at or before from that is not 0, -1 if none
+inline int last_nonzero_byte(const unsigned char *bytes, int from)
+{
+#if defined(BOOST_TRIE_HAS_SSE2)
+	for (int start = from & ~(byte_scan_width - 1); start >= 0; start -= byte_scan_width)
+	{
+		boost::uint32_t mask = nonzero_mask(bytes + start);
+		int top = from - start;
+		if (top < 31)
+			mask &= (2u << top) - 1;
+		if (mask)
+			return start + highest_bit(mask);
+	}
+#else
+	for (int b = from; b >= 0; --b)
+		if (bytes[b])
+			return b;
+#endif
+	return -1;
+}
+
+// first bit at or after from in a 256 bit set, -1 if none
+inline int first_set_bit(const boost::uint32_t *bits, int from)
+{
+	for (int w = from >> 5; w < 8; ++w)
+	{
+		boost::uint32_t word = bits[w];
+		if (w == (from >> 5))
+			word &= ~0u << (from & 31);
+		if (word)
+			return (w << 5) + lowest_bit(word);
+	}
+	return -1;
+}
+
+// last bit at or before from in a 256 bit set, -1 if none
+inline int last_set_bit(const boost::uint32_t *bits, int from)
+{
+	for (int w = from >> 5; w >= 0; --w)
+	{
+		boost::uint32_t word = bits[w];
+		if (w == (from >> 5) && (from & 31) < 31)
+			word &= (2u << (from & 31)) - 1;
+		if (word)
+			return (w << 5) + highest_bit(word);
+	}
+	return -1;
+}
+
+} /* detail */
+} /* tries */
+} /* boost */
+
+#endif
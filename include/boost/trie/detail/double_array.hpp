@@ -0,0 +1,298 @@
+#ifndef BOOST_TRIE_DOUBLE_ARRAY_HPP
+#define BOOST_TRIE_DOUBLE_ARRAY_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <vector>
+#include <stack>
+#include <algorithm>
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/is_signed.hpp>
+#include <boost/trie/detail/trie_children.hpp>
+
+namespace boost { namespace tries {
+
+namespace detail {
+
+/*
+ * Read only double-array (BASE/CHECK) trie over byte keys. State s has
+ * a transition on byte c to t = base[s] + c iff check[t] == s, so a
+ * lookup is one add and one compare per key element.
+ *
+ * The keys are numbered in sorted order when the array is built, so the
+ * keys below state s are the ranks starting at first_key[s] and spanning
+ * key_count[s]; the prefix queries and the iterators work on ranks.
+ * rank_state gives the state of each key, and the key itself is
+ * recovered by following check up to the root.
+ */
+template <typename Key>
+class double_array
+{
+	BOOST_STATIC_ASSERT_MSG(is_byte_key<Key>::value,
+			"double_array needs single byte integral keys");
+
+public:
+	typedef Key key_type;
+	typedef std::size_t size_type;
+	typedef boost::int32_t state_type;
+
+private:
+	enum { root_state = 0, free_slot = -1, alphabet_size = 256 };
+
+	std::vector<state_type> base;
+	std::vector<state_type> check;
+	std::vector<boost::uint32_t> first_key;
+	std::vector<boost::uint32_t> key_count;
+	std::vector<state_type> rank_state;
+	size_type state_count;
+
+	static key_type key_from_code(unsigned code)
+	{
+		return static_cast<key_type>(static_cast<unsigned char>(
+			code ^ (boost::is_signed<key_type>::value ? 0x80 : 0)));
+	}
+
+	void reserve_slots(size_type n)
+	{
+		if (check.size() < n)
+		{
+			base.resize(n, 0);
+			check.resize(n, free_slot);
+			first_key.resize(n, 0);
+			key_count.resize(n, 0);
+		}
+	}
+
+	/*
+	 * Lowest base from search_from on under which every code in codes
+	 * lands on a free slot. As in darts, a stretch that turned out to be
+	 * almost full is skipped by later searches, which costs a few holes
+	 * but keeps the build close to linear.
+	 */
+	state_type find_base(const std::vector<unsigned>& codes, size_type& search_from)
+	{
+		while (search_from < check.size() && check[search_from] != free_slot)
+			++search_from;
+		size_type used = 0;
+		for (size_type pos = std::max<size_type>(search_from, codes[0]); ; ++pos)
+		{
+			reserve_slots(pos + alphabet_size);
+			if (check[pos] != free_slot)
+			{
+				++used;
+				continue;
+			}
+			state_type b = static_cast<state_type>(pos - codes[0]);
+			bool fits = true;
+			for (size_type i = 1; i < codes.size() && fits; ++i)
+				fits = check[b + codes[i]] == free_slot;
+			if (!fits)
+				continue;
+			if (used * 20 >= (pos - search_from + 1) * 19)
+				search_from = pos;
+			return b;
+		}
+	}
+
+	state_type child(state_type s, unsigned code) const
+	{
+		size_type t = static_cast<size_type>(base[s]) + code;
+		if (t < check.size() && check[t] == s)
+			return static_cast<state_type>(t);
+		return free_slot;
+	}
+
+	struct build_frame {
+		state_type state;
+		size_type lo, hi, depth;
+	};
+
+public:
+	explicit double_array() : state_count(0)
+	{
+		clear();
+	}
+
+	void clear()
+	{
+		base.assign(1, 0);
+		check.assign(1, free_slot - 1);
+		first_key.assign(1, 0);
+		key_count.assign(1, 0);
+		rank_state.clear();
+		state_count = 0;
+	}
+
+	/*
+	 * Build from keys given as byte codes, sorted and without duplicates.
+	 * The ranks of the array are the positions in keys.
+	 */
+	void build(const std::vector<std::vector<unsigned char> >& keys)
+	{
+		clear();
+		rank_state.resize(keys.size());
+		key_count[root_state] = static_cast<boost::uint32_t>(keys.size());
+		size_type search_from = 1;
+		std::vector<unsigned> codes;
+		std::vector<build_frame> children;
+		std::stack<build_frame> stk;
+		build_frame root = { root_state, 0, keys.size(), 0 };
+		stk.push(root);
+		while (!stk.empty())
+		{
+			build_frame f = stk.top();
+			stk.pop();
+			size_type lo = f.lo;
+			if (lo < f.hi && keys[lo].size() == f.depth)
+				rank_state[lo++] = f.state;
+			if (lo == f.hi)
+				continue;
+
+			// one child per distinct element at depth, with its range of keys
+			codes.clear();
+			children.clear();
+			while (lo < f.hi)
+			{
+				size_type hi = lo + 1;
+				while (hi < f.hi && keys[hi][f.depth] == keys[lo][f.depth])
+					++hi;
+				codes.push_back(keys[lo][f.depth]);
+				build_frame cf = { 0, lo, hi, f.depth + 1 };
+				children.push_back(cf);
+				lo = hi;
+			}
+			state_type b = find_base(codes, search_from);
+			base[f.state] = b;
+			state_count += codes.size();
+			for (size_type i = 0; i < codes.size(); ++i)
+			{
+				state_type t = b + codes[i];
+				check[t] = f.state;
+				first_key[t] = static_cast<boost::uint32_t>(children[i].lo);
+				key_count[t] = static_cast<boost::uint32_t>(children[i].hi - children[i].lo);
+				children[i].state = t;
+			}
+			// pushed last to first so that the smallest child is placed next
+			for (size_type i = children.size(); i-- > 0; )
+				stk.push(children[i]);
+		}
+
+		// drop the unused tail left by the last reservation
+		size_type used = check.size();
+		while (used > 1 && check[used - 1] == free_slot)
+			--used;
+		base.resize(used);
+		check.resize(used);
+		first_key.resize(used);
+		key_count.resize(used);
+		std::vector<state_type>(base).swap(base);
+		std::vector<state_type>(check).swap(check);
+		std::vector<boost::uint32_t>(first_key).swap(first_key);
+		std::vector<boost::uint32_t>(key_count).swap(key_count);
+	}
+
+	/*
+	 * Follow [first, last) from the root. Returns the state reached, or
+	 * -1 if some element has no transition; matched is the number of
+	 * elements consumed before stopping.
+	 */
+	template <typename Iter>
+		state_type walk(Iter first, Iter last, size_type& matched) const
+		{
+			state_type s = root_state;
+			matched = 0;
+			for (; first != last; ++first, ++matched)
+			{
+				state_type t = child(s, byte_key_index(*first));
+				if (t == free_slot)
+					return free_slot;
+				s = t;
+			}
+			return s;
+		}
+
+	template <typename Iter>
+		state_type find_state(Iter first, Iter last) const
+		{
+			size_type matched;
+			return walk(first, last, matched);
+		}
+
+	bool is_terminal(state_type s) const
+	{
+		return key_count[s] != 0 && rank_state[first_key[s]] == s;
+	}
+
+	// first rank and number of keys below state s
+	size_type first_rank(state_type s) const
+	{
+		return first_key[s];
+	}
+
+	size_type prefix_count(state_type s) const
+	{
+		return key_count[s];
+	}
+
+	// rank of the first key not less than [first, last), exact is set on a full match
+	template <typename Iter>
+		size_type lower_bound_rank(Iter first, Iter last, bool& exact) const
+		{
+			state_type s = root_state;
+			exact = false;
+			for (; first != last; ++first)
+			{
+				unsigned code = byte_key_index(*first);
+				state_type t = child(s, code);
+				if (t == free_slot)
+				{
+					// the next child by code, or past the whole sub-trie
+					for (unsigned c = code + 1; c < alphabet_size; ++c)
+					{
+						t = child(s, c);
+						if (t != free_slot)
+							return first_key[t];
+					}
+					return first_key[s] + key_count[s];
+				}
+				s = t;
+			}
+			exact = is_terminal(s);
+			return first_key[s];
+		}
+
+	std::vector<key_type> get_key(size_type rank) const
+	{
+		std::vector<key_type> key_path;
+		for (state_type s = rank_state[rank]; s != root_state; s = check[s])
+			key_path.push_back(key_from_code(static_cast<unsigned>(s - base[check[s]])));
+		std::reverse(key_path.begin(), key_path.end());
+		return key_path;
+	}
+
+	size_type size() const
+	{
+		return rank_state.size();
+	}
+
+	// states other than the root, the count_node() of the source trie
+	size_type count_node() const
+	{
+		return state_count;
+	}
+
+	// number of slots of the BASE and CHECK arrays, used or not
+	size_type slot_count() const
+	{
+		return check.size();
+	}
+};
+
+} /* detail */
+} /* tries */
+} /* boost */
+
+#endif
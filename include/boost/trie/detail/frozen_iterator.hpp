@@ -0,0 +1,172 @@
+#ifndef BOOST_TRIE_FROZEN_ITERATOR_HPP
+#define BOOST_TRIE_FROZEN_ITERATOR_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <iterator>
+#include <boost/trie/detail/double_array.hpp>
+#include <boost/type_traits/is_void.hpp>
+#include <boost/utility/enable_if.hpp>
+
+namespace boost {  namespace tries {
+
+namespace detail {
+
+/*
+ * Iterator of the frozen tries: the keys of a double_array are numbered
+ * in order, so an iterator is just a rank
+ */
+template<typename Key, typename Value, typename Enable = void>
+struct frozen_iterator;
+
+template<typename Key, typename Value>
+struct frozen_iterator<Key, Value, typename boost::disable_if<boost::is_void<Value> >::type>
+{
+	typedef std::bidirectional_iterator_tag iterator_category;
+	typedef Key key_type;
+	typedef std::pair<std::vector<key_type>, Value> value_type;
+	typedef std::pair<std::vector<key_type>, const Value&> reference;
+	typedef std::pair<std::vector<key_type>, const Value&>* pointer;
+	typedef ptrdiff_t difference_type;
+	typedef frozen_iterator<Key, Value> self;
+	typedef double_array<Key> double_array_type;
+	typedef size_t size_type;
+
+	const double_array_type *trie;
+	const Value *values;
+	size_type rank;
+
+	explicit frozen_iterator() : trie(0), values(0), rank(0)
+	{
+	}
+
+	explicit frozen_iterator(const double_array_type *t, const Value *v, size_type r)
+		: trie(t), values(v), rank(r)
+	{
+	}
+
+	std::vector<key_type> get_key() const
+	{
+		return trie->get_key(rank);
+	}
+
+	reference operator*() const
+	{
+		return reference(get_key(), values[rank]);
+	}
+
+	bool operator==(const frozen_iterator& other) const
+	{
+		return rank == other.rank;
+	}
+
+	bool operator!=(const frozen_iterator& other) const
+	{
+		return rank != other.rank;
+	}
+
+	self& operator++()
+	{
+		++rank;
+		return *this;
+	}
+
+	self operator++(int)
+	{
+		self tmp = *this;
+		++rank;
+		return tmp;
+	}
+
+	self& operator--()
+	{
+		--rank;
+		return *this;
+	}
+
+	self operator--(int)
+	{
+		self tmp = *this;
+		--rank;
+		return tmp;
+	}
+};
+
+template<typename Key, typename Value>
+struct frozen_iterator<Key, Value, typename boost::enable_if<boost::is_void<Value> >::type>
+{
+	typedef std::bidirectional_iterator_tag iterator_category;
+	typedef Key key_type;
+	typedef std::vector<key_type> value_type;
+	typedef std::vector<key_type> reference;
+	typedef std::vector<key_type>* pointer;
+	typedef ptrdiff_t difference_type;
+	typedef frozen_iterator<Key, Value> self;
+	typedef double_array<Key> double_array_type;
+	typedef size_t size_type;
+
+	const double_array_type *trie;
+	size_type rank;
+
+	explicit frozen_iterator() : trie(0), rank(0)
+	{
+	}
+
+	explicit frozen_iterator(const double_array_type *t, size_type r) : trie(t), rank(r)
+	{
+	}
+
+	std::vector<key_type> get_key() const
+	{
+		return trie->get_key(rank);
+	}
+
+	reference operator*() const
+	{
+		return get_key();
+	}
+
+	bool operator==(const frozen_iterator& other) const
+	{
+		return rank == other.rank;
+	}
+
+	bool operator!=(const frozen_iterator& other) const
+	{
+		return rank != other.rank;
+	}
+
+	self& operator++()
+	{
+		++rank;
+		return *this;
+	}
+
+	self operator++(int)
+	{
+		self tmp = *this;
+		++rank;
+		return tmp;
+	}
+
+	self& operator--()
+	{
+		--rank;
+		return *this;
+	}
+
+	self operator--(int)
+	{
+		self tmp = *this;
+		--rank;
+		return tmp;
+	}
+};
+
+} /* detail */
+} /* tries */
+} /* boost */
+
+#endif
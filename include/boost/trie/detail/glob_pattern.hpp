@@ -0,0 +1,223 @@
+#ifndef BOOST_TRIE_GLOB_PATTERN_HPP
+#define BOOST_TRIE_GLOB_PATTERN_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <vector>
+#include <utility>
+#include <cstddef>
+
+namespace boost { namespace tries {
+
+namespace detail {
+
+/*
+ * A glob pattern compiled to a sequence of tokens: '?' matches any one
+ * element, '*' any sequence, "[a-z]" one element of a class ("[!...]" or
+ * "[^...]" for the complement) and '\' makes the next element literal.
+ * The special elements are key_type('?') and so on, which only means
+ * something for character keys.
+ *
+ * Matching is a set of positions in the pattern, one flag per position
+ * plus one for the end, stepped over the elements of a key. The end flag
+ * is set when the elements so far match the whole pattern.
+ */
+template <typename Key>
+class glob_pattern
+{
+public:
+	typedef Key key_type;
+	typedef std::size_t size_type;
+
+private:
+	enum token_kind { literal_token, any_token, star_token, class_token };
+
+	struct token {
+		token_kind kind;
+		key_type elem;
+		bool negate;
+		// the ranges of a class are ranges[first_range, last_range)
+		size_type first_range, last_range;
+	};
+
+	std::vector<token> tokens;
+	std::vector<std::pair<key_type, key_type> > ranges;
+
+	static bool is(const key_type& elem, char c)
+	{
+		return !(elem < key_type(c)) && !(key_type(c) < elem);
+	}
+
+	static bool equal(const key_type& a, const key_type& b)
+	{
+		return !(a < b) && !(b < a);
+	}
+
+	void add(token_kind kind, const key_type& elem)
+	{
+		token t;
+		t.kind = kind;
+		t.elem = elem;
+		t.negate = false;
+		t.first_range = t.last_range = 0;
+		tokens.push_back(t);
+	}
+
+	// parse the class starting after the '[' at p; returns the position
+	// after its ']', or p when the class is not closed
+	size_type parse_class(const std::vector<key_type>& pat, size_type p)
+	{
+		token t;
+		t.kind = class_token;
+		t.negate = false;
+		size_type i = p;
+		if (i < pat.size() && (is(pat[i], '!') || is(pat[i], '^')))
+		{
+			t.negate = true;
+			++i;
+		}
+		size_type start = i;
+		size_type old_ranges = ranges.size();
+		for (; i < pat.size(); ++i)
+		{
+			// a ']' first in the class is an element of it
+			if (is(pat[i], ']') && i != start)
+				break;
+			key_type lo = pat[i];
+			key_type hi = lo;
+			if (i + 2 < pat.size() && is(pat[i + 1], '-') && !is(pat[i + 2], ']'))
+			{
+				hi = pat[i + 2];
+				i += 2;
+			}
+			ranges.push_back(std::make_pair(lo, hi));
+		}
+		if (i == pat.size())
+		{
+			ranges.resize(old_ranges);
+			return p;
+		}
+		t.first_range = old_ranges;
+		t.last_range = ranges.size();
+		tokens.push_back(t);
+		return i + 1;
+	}
+
+	// a star may match nothing, so the position after it is reached too
+	void close(char *set) const
+	{
+		for (size_type p = 0; p < tokens.size(); ++p)
+			if (set[p] && tokens[p].kind == star_token)
+				set[p + 1] = 1;
+	}
+
+	bool accepts(const token& t, const key_type& elem) const
+	{
+		switch (t.kind)
+		{
+		case literal_token:
+			return equal(t.elem, elem);
+		case class_token:
+			for (size_type r = t.first_range; r < t.last_range; ++r)
+				if (!(elem < ranges[r].first) && !(ranges[r].second < elem))
+					return !t.negate;
+			return t.negate;
+		default:
+			return true;
+		}
+	}
+
+public:
+	template<typename Iter>
+	explicit glob_pattern(Iter first, Iter last)
+	{
+		const std::vector<key_type> pat(first, last);
+		for (size_type i = 0; i < pat.size(); )
+		{
+			const key_type& c = pat[i++];
+			if (is(c, '*'))
+			{
+				if (tokens.empty() || tokens.back().kind != star_token)
+					add(star_token, c);
+			}
+			else if (is(c, '?'))
+				add(any_token, c);
+			else if (is(c, '['))
+			{
+				size_type next = parse_class(pat, i);
+				if (next == i)
+					add(literal_token, c);
+				i = next;
+			}
+			else if (is(c, '\\') && i < pat.size())
+				add(literal_token, pat[i++]);
+			else
+				add(literal_token, c);
+		}
+	}
+
+	// flags in a position set, the last one for the end of the pattern
+	size_type width() const
+	{
+		return tokens.size() + 1;
+	}
+
+	// the set before any element
+	void start(char *set) const
+	{
+		for (size_type p = 0; p < width(); ++p)
+			set[p] = 0;
+		set[0] = 1;
+		close(set);
+	}
+
+	// to is the set after elem from the set from; returns whether it is not empty
+	bool step(const char *from, char *to, const key_type& elem) const
+	{
+		for (size_type p = 0; p < width(); ++p)
+			to[p] = 0;
+		for (size_type p = 0; p < tokens.size(); ++p)
+		{
+			if (!from[p])
+				continue;
+			if (tokens[p].kind == star_token)
+				to[p] = 1;
+			else if (accepts(tokens[p], elem))
+				to[p + 1] = 1;
+		}
+		close(to);
+		for (size_type p = 0; p < width(); ++p)
+			if (to[p])
+				return true;
+		return false;
+	}
+
+	bool accepting(const char *set) const
+	{
+		return set[tokens.size()] != 0;
+	}
+
+	// if the only position in set is a literal, its element, else NULL;
+	// then the one child that can match is found instead of scanned for
+	const key_type *only_literal(const char *set) const
+	{
+		const key_type *elem = NULL;
+		for (size_type p = 0; p < width(); ++p)
+		{
+			if (!set[p])
+				continue;
+			if (elem != NULL || p == tokens.size() || tokens[p].kind != literal_token)
+				return NULL;
+			elem = &tokens[p].elem;
+		}
+		return elem;
+	}
+};
+
+} /* detail */
+} /* tries */
+} /* boost */
+
+#endif
@@ -0,0 +1,161 @@
+#ifndef BOOST_TRIE_NODE_ARENA_HPP
+#define BOOST_TRIE_NODE_ARENA_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <cstddef>
+#include <new>
+#include <boost/utility.hpp>
+#include <boost/assert.hpp>
+
+namespace boost { namespace tries {
+
+namespace detail {
+
+/*
+ * Monotonic storage: blocks are carved out of big chunks by bumping a
+ * pointer and are never given back one by one. release() frees all the
+ * chunks at once, so the cost of dropping a whole trie is the number of
+ * chunks, not the number of nodes.
+ *
+ * The arena is shared by the allocator copies that point to it, counted
+ * here. Like the trie it is not thread safe.
+ */
+class node_arena : private boost::noncopyable
+{
+public:
+	typedef std::size_t size_type;
+
+private:
+	struct chunk_header {
+		chunk_header *next;
+		size_type size;
+	};
+
+	enum { header_size = (sizeof(chunk_header) + 15) & ~size_type(15) };
+
+	chunk_header *chunks;
+	char *cur;
+	char *limit;
+	size_type chunk_size;
+	size_type chunk_num;
+	size_type used;
+	size_type refs;
+
+	char *new_chunk(size_type size)
+	{
+		char *raw = static_cast<char *>(::operator new(header_size + size));
+		chunk_header *header = reinterpret_cast<chunk_header *>(raw);
+		header->next = chunks;
+		header->size = size;
+		chunks = header;
+		++chunk_num;
+		return raw + header_size;
+	}
+
+public:
+	explicit node_arena(size_type chunk_size) : chunks(NULL), cur(NULL), limit(NULL),
+		chunk_size(chunk_size), chunk_num(0), used(0), refs(0)
+	{
+	}
+
+	~node_arena()
+	{
+		release();
+	}
+
+	void *allocate(size_type size, size_type align)
+	{
+		used += size;
+		// big blocks get a chunk of their own, so the current one is kept
+		if (size > chunk_size / 4)
+			return new_chunk(size);
+		size_type pad = (align - reinterpret_cast<size_type>(cur) % align) % align;
+		if (cur == NULL || size + pad > static_cast<size_type>(limit - cur))
+		{
+			cur = new_chunk(chunk_size);
+			limit = cur + chunk_size;
+			pad = 0;
+		}
+		void *ret = cur + pad;
+		cur += pad + size;
+		return ret;
+	}
+
+	// free every chunk, whatever was allocated from them is gone
+	void release()
+	{
+		while (chunks != NULL)
+		{
+			chunk_header *next = chunks->next;
+			::operator delete(chunks);
+			chunks = next;
+		}
+		cur = limit = NULL;
+		chunk_num = 0;
+		used = 0;
+	}
+
+	size_type chunk_count() const
+	{
+		return chunk_num;
+	}
+
+	// bytes handed out since the last release, including the dead ones
+	size_type bytes_used() const
+	{
+		return used;
+	}
+
+	size_type get_chunk_size() const
+	{
+		return chunk_size;
+	}
+
+	void add_ref()
+	{
+		++refs;
+	}
+
+	// true when the last reference is gone and the arena should be deleted
+	bool remove_ref()
+	{
+		BOOST_ASSERT(refs > 0);
+		return --refs == 0;
+	}
+
+	// number of allocators pointing to the arena
+	size_type ref_count() const
+	{
+		return refs;
+	}
+};
+
+/*
+ * What a trie needs to know about its allocator to release its nodes in
+ * bulk. Ordinary allocators have nothing to release; arena_allocator
+ * specializes this.
+ */
+template <typename Alloc>
+struct arena_hooks {
+	enum { is_arena = false };
+
+	// whether the held allocators of the caller are all the copies of
+	// its allocator, so that nothing else can own memory in the arena
+	static bool sole_owner(const Alloc&, std::size_t)
+	{
+		return false;
+	}
+
+	static void release(Alloc&)
+	{
+	}
+};
+
+} /* detail */
+} /* tries */
+} /* boost */
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef BOOST_TRIE_NODE_POOL_HPP
+#define BOOST_TRIE_NODE_POOL_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <cstddef>
+#include <boost/utility.hpp>
+#include <boost/assert.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/container/allocator_traits.hpp>
+
+namespace boost { namespace tries {
+
+namespace detail {
+
+/*
+ * Free list of raw blocks for single objects of type T, threaded through
+ * the blocks themselves. At most cap blocks are kept; push() refuses the
+ * rest and the caller gives them back to its allocator.
+ */
+template <typename T>
+class node_free_list : private boost::noncopyable
+{
+public:
+	typedef std::size_t size_type;
+
+private:
+	struct link {
+		link *next;
+	};
+
+	link *head;
+	size_type count;
+	size_type cap;
+
+public:
+	explicit node_free_list() : head(NULL), count(0), cap(0)
+	{
+	}
+
+	~node_free_list()
+	{
+		BOOST_ASSERT(head == NULL);
+	}
+
+	// NULL when there is nothing to reuse
+	T *pop()
+	{
+		if (head == NULL)
+			return NULL;
+		link *l = head;
+		head = l->next;
+		--count;
+		return reinterpret_cast<T *>(l);
+	}
+
+	bool push(T *block)
+	{
+		BOOST_STATIC_ASSERT(sizeof(T) >= sizeof(link));
+		if (count >= cap)
+			return false;
+		link *l = reinterpret_cast<link *>(block);
+		l->next = head;
+		head = l;
+		++count;
+		return true;
+	}
+
+	// hand the blocks above keep back to alloc
+	template <typename Alloc>
+	void trim(Alloc& alloc, size_type keep)
+	{
+		while (count > keep)
+			boost::container::allocator_traits<Alloc>::deallocate(alloc, pop(), 1);
+	}
+
+	size_type size() const
+	{
+		return count;
+	}
+
+	size_type get_cap() const
+	{
+		return cap;
+	}
+
+	void set_cap(size_type n)
+	{
+		cap = n;
+	}
+};
+
+} /* detail */
+} /* tries */
+} /* boost */
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef BOOST_TRIE_PREFETCH_HPP
+#define BOOST_TRIE_PREFETCH_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+namespace boost { namespace tries {
+
+namespace detail {
+
+// hint that *p will be read soon; does nothing where there is no hint
+inline void prefetch_read(const void *p)
+{
+#if defined(__GNUC__)
+	__builtin_prefetch(p, 0, 3);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	_mm_prefetch(static_cast<const char *>(p), _MM_HINT_T0);
+#else
+	(void)p;
+#endif
+}
+
+} /* detail */
+} /* tries */
+} /* boost */
+
+#endif
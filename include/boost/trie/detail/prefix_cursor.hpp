@@ -0,0 +1,158 @@
+#ifndef BOOST_TRIE_PREFIX_CURSOR_HPP
+#define BOOST_TRIE_PREFIX_CURSOR_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <utility>
+#include <boost/trie/detail/trie_node.hpp>
+#include <boost/trie/detail/trie_iterator.hpp>
+#include <boost/type_traits/remove_const.hpp>
+
+namespace boost { namespace tries {
+
+namespace detail {
+
+/*
+ * The node of a prefix that grows and shrinks one element at a time, as
+ * in search as you type: extend() is one child lookup and retract() one
+ * step to the parent, instead of a walk from the root per keystroke.
+ *
+ * Elements that lead out of the trie are counted rather than followed,
+ * so retracting them comes back to where the prefix left the trie. The
+ * cursor is a plain value, cheap to copy; any erase from the trie may
+ * invalidate it.
+ */
+template <typename Key, typename Value, bool isMultiValue,
+	typename ChildPolicy = adaptive_children_policy>
+class prefix_cursor
+{
+public:
+	typedef Key key_type;
+	typedef typename boost::remove_const<Value>::type non_const_value_type;
+	typedef trie_node<Key, non_const_value_type, isMultiValue, ChildPolicy> trie_node_type;
+	typedef trie_node_type* trie_node_ptr;
+	typedef trie_iterator<Key, Value, isMultiValue, ChildPolicy> iterator;
+	typedef std::pair<iterator, iterator> iterator_range;
+	typedef std::size_t size_type;
+
+private:
+	trie_node_ptr tnode;
+	// elements extended past the last node found
+	size_type misses;
+	size_type prefix_length;
+
+	// first node with a value in the sub-trie of node
+	static trie_node_ptr leftmost_node(trie_node_ptr node)
+	{
+		while (!node->children.empty() && node->no_value())
+			node = node->children.front();
+		return node;
+	}
+
+	// first node with a value after the sub-trie of node, the root if none
+	static trie_node_ptr next_subtree(trie_node_ptr node)
+	{
+		while (node->parent != NULL)
+		{
+			trie_node_ptr sibling = node->parent->children.next(node);
+			if (sibling != NULL)
+				return leftmost_node(sibling);
+			node = node->parent;
+		}
+		return node;
+	}
+
+	trie_node_ptr root() const
+	{
+		trie_node_ptr cur = tnode;
+		while (cur->parent != NULL)
+			cur = cur->parent;
+		return cur;
+	}
+
+public:
+	explicit prefix_cursor() : tnode(0), misses(0), prefix_length(0)
+	{
+	}
+
+	// the empty prefix of the trie with root as its root
+	explicit prefix_cursor(trie_node_ptr root) : tnode(root), misses(0), prefix_length(0)
+	{
+	}
+
+	// append elem to the prefix; false once the prefix is in no key
+	bool extend(const key_type& elem)
+	{
+		++prefix_length;
+		if (misses == 0)
+		{
+			trie_node_ptr child = tnode->children.find(elem);
+			if (child != NULL)
+			{
+				tnode = child;
+				return true;
+			}
+		}
+		++misses;
+		return false;
+	}
+
+	// drop the last element of the prefix, nothing if it is empty
+	void retract()
+	{
+		if (prefix_length == 0)
+			return;
+		--prefix_length;
+		if (misses != 0)
+			--misses;
+		else
+			tnode = tnode->parent;
+	}
+
+	size_type length() const
+	{
+		return prefix_length;
+	}
+
+	// whether some key starts with the prefix
+	bool valid() const
+	{
+		return misses == 0 && tnode->value_count != 0;
+	}
+
+	// whether the prefix is itself a key
+	bool has_value() const
+	{
+		return misses == 0 && tnode->parent != NULL && !tnode->no_value();
+	}
+
+	// number of values under the prefix
+	size_type count() const
+	{
+		return misses == 0 ? tnode->value_count : 0;
+	}
+
+	// the values under the prefix, as find_prefix() gives them
+	iterator_range range() const
+	{
+		if (misses != 0)
+		{
+			iterator end(root());
+			return std::make_pair(end, end);
+		}
+		return std::make_pair(iterator(leftmost_node(tnode)), iterator(next_subtree(tnode)));
+	}
+
+	trie_node_ptr node() const
+	{
+		return misses == 0 ? tnode : NULL;
+	}
+};
+
+} /* detail */
+} /* tries */
+} /* boost */
+
+#endif
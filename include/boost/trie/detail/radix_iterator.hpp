@@ -0,0 +1,271 @@
+#ifndef BOOST_TRIE_RADIX_ITERATOR_HPP
+#define BOOST_TRIE_RADIX_ITERATOR_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <vector>
+#include <iterator>
+#include <boost/trie/detail/radix_node.hpp>
+#include <boost/type_traits/remove_const.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/utility/enable_if.hpp>
+
+namespace boost {  namespace tries {
+
+namespace detail {
+
+/*
+ * Traversal shared by the map and the set iterators of the radix trie,
+ * the same walk as trie_iterator over nodes with a value
+ */
+template <typename Node>
+struct radix_iterator_base
+{
+	typedef Node radix_node_type;
+	typedef radix_node_type* radix_node_ptr;
+	typedef typename radix_node_type::key_type key_type;
+	typedef size_t size_type;
+
+	radix_node_ptr tnode;
+
+	explicit radix_iterator_base(radix_node_ptr x) : tnode(x)
+	{
+	}
+
+	std::vector<key_type> get_key() const
+	{
+		size_type path_length = 0;
+		radix_node_ptr cur;
+		for (cur = tnode; cur->parent != NULL; cur = cur->parent)
+			path_length += cur->label_size();
+		std::vector<key_type> key_path(path_length);
+		for (cur = tnode; cur->parent != NULL; cur = cur->parent)
+		{
+			path_length -= cur->label_size();
+			key_path[path_length] = cur->key;
+			std::copy(cur->tail.begin(), cur->tail.end(), key_path.begin() + path_length + 1);
+		}
+		return key_path;
+	}
+
+	bool go_down_forward() {
+		if (tnode->children.empty())
+			return false;
+		do  {
+			tnode = tnode->children.front();
+		} while (!tnode->children.empty() && tnode->no_value());
+		return true;
+	}
+
+	void go_down_backward() {
+		while (!tnode->children.empty())
+			tnode = tnode->children.back();
+	}
+
+	void increment()
+	{
+		if (tnode->parent == NULL)
+			return;
+		if (go_down_forward())
+			return;
+		while (tnode->parent != NULL) {
+			radix_node_ptr sibling = tnode->parent->children.next(tnode);
+			if (sibling != NULL) {
+				tnode = sibling;
+				if (tnode->no_value())
+					go_down_forward();
+				return;
+			}
+			tnode = tnode->parent;
+		}
+	}
+
+	void decrement()
+	{
+		if (tnode->parent == NULL) {
+			go_down_backward();
+			return;
+		}
+		do {
+			radix_node_ptr sibling = tnode->parent->children.prev(tnode);
+			if (sibling != NULL) {
+				tnode = sibling;
+				go_down_backward();
+				return;
+			}
+			tnode = tnode->parent;
+		} while (tnode->parent != NULL && tnode->no_value());
+		// ran off the front, stay on the first element
+		if (tnode->parent == NULL)
+			go_down_forward();
+	}
+};
+
+template<typename Key, typename Value, typename ChildPolicy = adaptive_children_policy,
+	typename Enable = void>
+struct radix_iterator;
+
+template<typename Key, typename Value, typename ChildPolicy>
+struct radix_iterator<Key, Value, ChildPolicy,
+	typename boost::disable_if<boost::is_same<typename boost::remove_const<Value>::type, void> >::type>
+	: public radix_iterator_base<radix_node<Key, typename boost::remove_const<Value>::type, ChildPolicy> >
+{
+	typedef std::bidirectional_iterator_tag iterator_category;
+	typedef Key key_type;
+	typedef std::pair<std::vector<key_type>, Value> value_type;
+	typedef std::pair<std::vector<key_type>, Value&> reference;
+	typedef std::pair<std::vector<key_type>, Value&>* pointer;
+	typedef ptrdiff_t difference_type;
+	typedef typename boost::remove_const<Value>::type non_const_value_type;
+	typedef radix_iterator<Key, non_const_value_type, ChildPolicy> iterator;
+	typedef radix_iterator<Key, Value, ChildPolicy> self;
+	typedef radix_iterator<Key, const Value, ChildPolicy> const_iterator;
+	typedef radix_node<Key, non_const_value_type, ChildPolicy> radix_node_type;
+	typedef radix_node_type* radix_node_ptr;
+	typedef radix_iterator_base<radix_node_type> base_type;
+
+	explicit radix_iterator() : base_type(0)
+	{
+	}
+
+	radix_iterator(radix_node_ptr x) : base_type(x)
+	{
+	}
+
+	radix_iterator(const iterator &it) : base_type(it.tnode)
+	{
+	}
+
+	self& operator=(const self& other)
+	{
+		this->tnode = other.tnode;
+		return *this;
+	}
+
+	reference operator*() const
+	{
+		return reference(this->get_key(), this->tnode->value);
+	}
+
+	bool operator==(const radix_iterator& other) const
+	{
+		return this->tnode == other.tnode;
+	}
+
+	bool operator!=(const radix_iterator& other) const
+	{
+		return this->tnode != other.tnode;
+	}
+
+	self& operator++()
+	{
+		this->increment();
+		return *this;
+	}
+
+	self operator++(int)
+	{
+		self tmp = *this;
+		this->increment();
+		return tmp;
+	}
+
+	self& operator--()
+	{
+		this->decrement();
+		return *this;
+	}
+
+	self operator--(int)
+	{
+		self tmp = *this;
+		this->decrement();
+		return tmp;
+	}
+};
+
+template<typename Key, typename Value, typename ChildPolicy>
+struct radix_iterator<Key, Value, ChildPolicy,
+	typename boost::enable_if<boost::is_same<typename boost::remove_const<Value>::type, void> >::type>
+	: public radix_iterator_base<radix_node<Key, void, ChildPolicy> >
+{
+	typedef std::bidirectional_iterator_tag iterator_category;
+	typedef Key key_type;
+	typedef std::vector<key_type> value_type;
+	typedef std::vector<key_type> reference;
+	typedef std::vector<key_type>* pointer;
+	typedef ptrdiff_t difference_type;
+	typedef radix_iterator<Key, void, ChildPolicy> iterator;
+	typedef radix_iterator<Key, Value, ChildPolicy> self;
+	typedef radix_iterator<Key, const void, ChildPolicy> const_iterator;
+	typedef radix_node<Key, void, ChildPolicy> radix_node_type;
+	typedef radix_node_type* radix_node_ptr;
+	typedef radix_iterator_base<radix_node_type> base_type;
+
+	explicit radix_iterator() : base_type(0)
+	{
+	}
+
+	radix_iterator(radix_node_ptr x) : base_type(x)
+	{
+	}
+
+	radix_iterator(const iterator &it) : base_type(it.tnode)
+	{
+	}
+
+	self& operator=(const self& other)
+	{
+		this->tnode = other.tnode;
+		return *this;
+	}
+
+	reference operator*() const
+	{
+		return this->get_key();
+	}
+
+	bool operator==(const radix_iterator& other) const
+	{
+		return this->tnode == other.tnode;
+	}
+
+	bool operator!=(const radix_iterator& other) const
+	{
+		return this->tnode != other.tnode;
+	}
+
+	self& operator++()
+	{
+		this->increment();
+		return *this;
+	}
+
+	self operator++(int)
+	{
+		self tmp = *this;
+		this->increment();
+		return tmp;
+	}
+
+	self& operator--()
+	{
+		this->decrement();
+		return *this;
+	}
+
+	self operator--(int)
+	{
+		self tmp = *this;
+		this->decrement();
+		return tmp;
+	}
+};
+
+} /* detail */
+} /* tries */
+} /* boost */
+
+#endif
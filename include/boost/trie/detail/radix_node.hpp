@@ -0,0 +1,253 @@
+#ifndef BOOST_TRIE_RADIX_NODE_HPP
+#define BOOST_TRIE_RADIX_NODE_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <cstddef>
+#include <memory>
+#include <iterator>
+#include <algorithm>
+#include <boost/assert.hpp>
+#include <boost/utility.hpp>
+#include <boost/blank.hpp>
+#include <boost/mpl/if.hpp>
+#include <boost/type_traits/is_void.hpp>
+#include <boost/trie/detail/trie_children.hpp>
+
+namespace boost { namespace tries {
+
+namespace detail {
+
+template <typename Key>
+inline bool key_equal(const Key& a, const Key& b)
+{
+	return !(a < b) && !(b < a);
+}
+
+/*
+ * The elements of an edge label after its first. Labels of up to
+ * InlineSize elements are kept in the node itself, so the edges of a
+ * typical radix trie cost no allocation and no pointer to follow; longer
+ * ones move to a block from the allocator of the trie, which has to be
+ * handed back with release() before the label goes away.
+ */
+template <typename Key, std::size_t InlineSize>
+class radix_label : private boost::noncopyable
+{
+public:
+	typedef Key key_type;
+	typedef const key_type* const_iterator;
+	typedef std::size_t size_type;
+
+private:
+	key_type inline_elems[InlineSize];
+	// NULL while the elements are inline
+	key_type *block;
+	size_type length;
+	size_type capacity;
+
+	key_type *data()
+	{
+		return block != NULL ? block : inline_elems;
+	}
+
+	template <typename Alloc>
+	static void free_block(key_type *old, size_type old_capacity, size_type elems, Alloc& alloc)
+	{
+		if (old == NULL)
+			return;
+		for (size_type i = 0; i < elems; ++i)
+			old[i].~key_type();
+		deallocate_block(alloc, old, old_capacity);
+	}
+
+public:
+	explicit radix_label() : block(NULL), length(0), capacity(InlineSize)
+	{
+	}
+
+	~radix_label()
+	{
+		BOOST_ASSERT(block == NULL);
+	}
+
+	const_iterator begin() const
+	{
+		return block != NULL ? block : inline_elems;
+	}
+
+	const_iterator end() const
+	{
+		return begin() + length;
+	}
+
+	size_type size() const
+	{
+		return length;
+	}
+
+	const key_type& operator[](size_type i) const
+	{
+		return begin()[i];
+	}
+
+	// replace the elements with [first, last)
+	template <typename Iter, typename Alloc>
+	void assign(Iter first, Iter last, Alloc& alloc)
+	{
+		size_type n = static_cast<size_type>(std::distance(first, last));
+		release(alloc);
+		if (n <= InlineSize)
+		{
+			std::copy(first, last, inline_elems);
+			length = n;
+			return;
+		}
+		key_type *fresh = allocate_block<key_type>(alloc, n);
+		size_type built = 0;
+		try {
+			for (; first != last; ++first, ++built)
+				new(fresh + built) key_type(*first);
+		} catch (...) {
+			free_block(fresh, n, built, alloc);
+			throw;
+		}
+		block = fresh;
+		capacity = n;
+		length = n;
+	}
+
+	// drop the first n elements, the storage stays
+	void erase_front(size_type n)
+	{
+		key_type *d = data();
+		std::copy(d + n, d + length, d);
+		if (block != NULL)
+			for (size_type i = length - n; i < length; ++i)
+				d[i].~key_type();
+		length -= n;
+	}
+
+	// put front and then elem before the elements, for merging an edge
+	// with the one above it; a bigger block is only taken over once all
+	// of its elements are built
+	template <typename Alloc>
+	void prepend(const radix_label& front, const key_type& elem, Alloc& alloc)
+	{
+		size_type shift = front.size() + 1;
+		size_type old_length = length;
+		size_type n = length + shift;
+		if (n <= capacity)
+		{
+			key_type *d = data();
+			// past the elements a block is raw storage, counted as it is built
+			if (block != NULL)
+				for (; length < n; ++length)
+					new(d + length) key_type();
+			std::copy_backward(d, d + old_length, d + n);
+			std::copy(front.begin(), front.end(), d);
+			d[front.size()] = elem;
+			length = n;
+			return;
+		}
+		key_type *grown = allocate_block<key_type>(alloc, n);
+		size_type built = 0;
+		try {
+			for (; built < front.size(); ++built)
+				new(grown + built) key_type(front[built]);
+			new(grown + built) key_type(elem);
+			++built;
+			for (const_iterator it = begin(); built < n; ++built, ++it)
+				new(grown + built) key_type(*it);
+		} catch (...) {
+			free_block(grown, n, built, alloc);
+			throw;
+		}
+		free_block(block, capacity, length, alloc);
+		block = grown;
+		capacity = n;
+		length = n;
+	}
+
+	// give the block back, leaving the label empty
+	template <typename Alloc>
+	void release(Alloc& alloc)
+	{
+		free_block(block, capacity, length, alloc);
+		block = NULL;
+		length = 0;
+		capacity = InlineSize;
+	}
+};
+
+// as many elements as fit in two pointers, at least one
+template <typename Key>
+struct radix_inline_label
+{
+	static const std::size_t value = sizeof(Key) < 2 * sizeof(void*) ? 2 * sizeof(void*) / sizeof(Key) : 1;
+};
+
+/*
+ * Node of a path compressed trie. The edge from the parent is labelled
+ * with key followed by tail; children are indexed by the first element
+ * of their edge, so the child containers of trie_node are reused as is.
+ * Every node but the root has a value or at least two children.
+ */
+template <typename Key, typename Value, typename ChildPolicy = adaptive_children_policy>
+struct radix_node : private boost::noncopyable,
+	public ChildPolicy::hook_type
+{
+	typedef Key key_type;
+	typedef typename boost::mpl::if_
+	<
+		boost::is_void<Value>,
+		boost::blank,
+		Value
+	>::type value_type;
+	typedef size_t size_type;
+	typedef radix_node<Key, Value, ChildPolicy> node_type;
+	typedef node_type* node_ptr;
+	typedef radix_label<key_type, radix_inline_label<key_type>::value> label_type;
+	typedef typename ChildPolicy::template children<key_type, node_type>::type children_type;
+
+	key_type key;
+	label_type tail;
+	children_type children;
+	node_ptr parent;
+	size_type value_count;
+	bool has_value;
+	value_type value;
+
+	explicit radix_node() : parent(0), value_count(0), has_value(false), value()
+	{
+	}
+
+	explicit radix_node(const key_type& key) : key(key), parent(0), value_count(0),
+		has_value(false), value()
+	{
+	}
+
+	// number of key elements on the edge from the parent
+	size_type label_size() const
+	{
+		return parent == NULL ? 0 : tail.size() + 1;
+	}
+
+	size_type count() const
+	{
+		return has_value;
+	}
+
+	bool no_value() const
+	{
+		return !has_value;
+	}
+};
+
+} /* detail */
+} /* tries */
+} /* boost */
+
+#endif
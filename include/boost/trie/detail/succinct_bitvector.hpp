@@ -0,0 +1,188 @@
+#ifndef BOOST_TRIE_SUCCINCT_BITVECTOR_HPP
+#define BOOST_TRIE_SUCCINCT_BITVECTOR_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <boost/assert.hpp>
+#include <boost/trie/detail/byte_search.hpp>
+
+namespace boost { namespace tries {
+
+namespace detail {
+
+inline int bit_count64(boost::uint64_t x)
+{
+	return bit_count(static_cast<boost::uint32_t>(x))
+		+ bit_count(static_cast<boost::uint32_t>(x >> 32));
+}
+
+// position of the k-th (from 0) set bit of x, which must have more than k
+inline int select_in_word(boost::uint64_t x, int k)
+{
+	boost::uint32_t low = static_cast<boost::uint32_t>(x);
+	int low_count = bit_count(low);
+	int offset = 0;
+	boost::uint32_t word = low;
+	if (k >= low_count)
+	{
+		word = static_cast<boost::uint32_t>(x >> 32);
+		k -= low_count;
+		offset = 32;
+	}
+	for (; k > 0; --k)
+		word &= word - 1;
+	return offset + lowest_bit(word);
+}
+
+/*
+ * Append only bit vector with rank and select. A cumulative count of
+ * ones is kept for every 512 bits, about 6% on top of the bits; select
+ * searches that directory and then scans at most eight words.
+ */
+class succinct_bitvector
+{
+public:
+	typedef std::size_t size_type;
+
+private:
+	enum { word_bits = 64, block_words = 8, block_bits = 512 };
+
+	std::vector<boost::uint64_t> words;
+	std::vector<boost::uint32_t> block_rank;
+	size_type bit_size;
+
+	size_type block_zeros(size_type block) const
+	{
+		return block * block_bits - block_rank[block];
+	}
+
+public:
+	explicit succinct_bitvector() : bit_size(0)
+	{
+	}
+
+	void clear()
+	{
+		words.clear();
+		block_rank.clear();
+		bit_size = 0;
+	}
+
+	void push_back(bool bit)
+	{
+		if (bit_size % word_bits == 0)
+			words.push_back(0);
+		if (bit)
+			words.back() |= boost::uint64_t(1) << (bit_size % word_bits);
+		++bit_size;
+	}
+
+	// must be called once all bits are in, before rank or select
+	void build()
+	{
+		std::vector<boost::uint64_t>(words).swap(words);
+		size_type blocks = bit_size / block_bits + 1;
+		block_rank.assign(blocks + 1, 0);
+		boost::uint32_t ones = 0;
+		for (size_type w = 0; w < blocks * block_words; ++w)
+		{
+			if (w % block_words == 0)
+				block_rank[w / block_words] = ones;
+			if (w < words.size())
+				ones += bit_count64(words[w]);
+		}
+		block_rank[blocks] = ones;
+	}
+
+	size_type size() const
+	{
+		return bit_size;
+	}
+
+	bool operator[](size_type i) const
+	{
+		return (words[i / word_bits] >> (i % word_bits)) & 1;
+	}
+
+	// ones in [0, i)
+	size_type rank1(size_type i) const
+	{
+		size_type block = i / block_bits;
+		size_type r = block_rank[block];
+		for (size_type w = block * block_words; w < i / word_bits; ++w)
+			r += bit_count64(words[w]);
+		if (i % word_bits)
+			r += bit_count64(words[i / word_bits]
+				& ((boost::uint64_t(1) << (i % word_bits)) - 1));
+		return r;
+	}
+
+	// zeros in [0, i)
+	size_type rank0(size_type i) const
+	{
+		return i - rank1(i);
+	}
+
+	// position of the k-th (from 0) one
+	size_type select1(size_type k) const
+	{
+		size_type lo = 0, hi = block_rank.size() - 1;
+		while (hi - lo > 1)
+		{
+			size_type mid = (lo + hi) / 2;
+			if (block_rank[mid] <= k)
+				lo = mid;
+			else
+				hi = mid;
+		}
+		k -= block_rank[lo];
+		for (size_type w = lo * block_words; ; ++w)
+		{
+			BOOST_ASSERT(w < words.size());
+			size_type ones = bit_count64(words[w]);
+			if (k < ones)
+				return w * word_bits + select_in_word(words[w], static_cast<int>(k));
+			k -= ones;
+		}
+	}
+
+	// position of the k-th (from 0) zero
+	size_type select0(size_type k) const
+	{
+		size_type lo = 0, hi = block_rank.size() - 1;
+		while (hi - lo > 1)
+		{
+			size_type mid = (lo + hi) / 2;
+			if (block_zeros(mid) <= k)
+				lo = mid;
+			else
+				hi = mid;
+		}
+		k -= block_zeros(lo);
+		for (size_type w = lo * block_words; ; ++w)
+		{
+			BOOST_ASSERT(w < words.size());
+			size_type zeros = word_bits - bit_count64(words[w]);
+			if (k < zeros)
+				return w * word_bits + select_in_word(~words[w], static_cast<int>(k));
+			k -= zeros;
+		}
+	}
+
+	// bytes used by the bits and the rank directory
+	size_type memory_size() const
+	{
+		return words.size() * sizeof(boost::uint64_t)
+			+ block_rank.size() * sizeof(boost::uint32_t);
+	}
+};
+
+} /* detail */
+} /* tries */
+} /* boost */
+
+#endif
@@ -0,0 +1,1177 @@
+#ifndef BOOST_TRIE_CHILDREN_HPP
+#define BOOST_TRIE_CHILDREN_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <boost/utility.hpp>
+#include <boost/assert.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/integral_constant.hpp>
+#include <boost/type_traits/is_integral.hpp>
+#include <boost/type_traits/is_signed.hpp>
+#include <boost/container/allocator_traits.hpp>
+#include <boost/trie/detail/byte_search.hpp>
+#include <boost/intrusive/set.hpp>
+
+namespace boost { namespace tries {
+
+namespace detail {
+
+/*
+ * Keys that fit in a single byte can be used as an array index, which is
+ * what makes the 48 and 256 slot node kinds possible
+ */
+template <typename Key>
+struct is_byte_key : boost::integral_constant<bool,
+	boost::is_integral<Key>::value && sizeof(Key) == 1>
+{
+};
+
+// map a byte key to [0, 256) so that the order of operator< is preserved
+template <typename Key>
+inline unsigned char byte_key_index(const Key& key)
+{
+	return static_cast<unsigned char>(
+		static_cast<unsigned char>(key) ^ (boost::is_signed<Key>::value ? 0x80 : 0));
+}
+
+template <typename Alloc, typename T>
+struct rebind_alloc {
+	typedef typename boost::container::allocator_traits<Alloc>::
+		template portable_rebind_alloc<T>::type type;
+};
+
+// the block helpers only deal with raw storage, nothing is constructed
+template <typename T, typename Alloc>
+inline T* allocate_block(Alloc& alloc, std::size_t n)
+{
+	typename rebind_alloc<Alloc, T>::type block_alloc(alloc);
+	return block_alloc.allocate(n);
+}
+
+template <typename T, typename Alloc>
+inline void deallocate_block(Alloc& alloc, T* block, std::size_t n)
+{
+	typename rebind_alloc<Alloc, T>::type block_alloc(alloc);
+	block_alloc.deallocate(block, n);
+}
+
+/*
+ * Adaptive container of the children of a trie node, in the spirit of the
+ * adaptive radix tree. Up to four children are kept inline in the node, so
+ * the long single child chains of a trie need no allocation besides the
+ * nodes themselves. Bigger nodes switch to a heap block whose layout
+ * depends on the fanout. An empty container never owns a block.
+ *
+ * The container does not own the children; mutating operations take the
+ * allocator of the trie so that blocks come from the same place as nodes.
+ */
+template <typename Key, typename Node, bool ByteKey = is_byte_key<Key>::value>
+class adaptive_children;
+
+/*
+ * Byte keys: sorted arrays of 4 (inline) and 16 key bytes, a 256 entry
+ * index into 48 child slots and finally a direct 256 entry table.
+ * A node shrinks back to a smaller kind with some hysteresis.
+ * The 16 key array and the ordered scans of the bigger kinds are
+ * searched with vector compares where available (see byte_search.hpp).
+ */
+template <typename Key, typename Node>
+class adaptive_children<Key, Node, true> : private boost::noncopyable
+{
+public:
+	typedef Key key_type;
+	typedef Node node_type;
+	typedef node_type * node_ptr;
+	typedef std::size_t size_type;
+
+private:
+	enum node_kind { node4 = 0, node16 = 1, node48 = 2, node256 = 3 };
+
+	enum {
+		shrink16_size = 3,
+		shrink48_size = 12,
+		shrink256_size = 40
+	};
+
+	struct node16_block {
+		unsigned char keys[16];
+		node_ptr children[16];
+	};
+
+	// index holds slot + 1 for every present key, 0 otherwise
+	struct node48_block {
+		unsigned char index[256];
+		node_ptr children[48];
+	};
+
+	// present mirrors the non null children, for the ordered scans
+	struct node256_block {
+		node_ptr children[256];
+		boost::uint32_t present[8];
+	};
+
+	unsigned char kind;
+	unsigned char small_keys[4];
+	unsigned short child_count;
+	union {
+		node_ptr small_children[4];
+		node16_block *n16;
+		node48_block *n48;
+		node256_block *n256;
+	} slots;
+
+	bool is_sorted_kind() const
+	{
+		return kind == node4 || kind == node16;
+	}
+
+	const unsigned char *sorted_keys() const
+	{
+		return kind == node4 ? small_keys : slots.n16->keys;
+	}
+
+	unsigned char *sorted_keys()
+	{
+		return kind == node4 ? small_keys : slots.n16->keys;
+	}
+
+	node_ptr const *sorted_children() const
+	{
+		return kind == node4 ? slots.small_children : slots.n16->children;
+	}
+
+	node_ptr *sorted_children()
+	{
+		return kind == node4 ? slots.small_children : slots.n16->children;
+	}
+
+	// first position whose key is not less than b
+	size_type lower_index(unsigned char b) const
+	{
+		if (kind == node16)
+			return sorted16_lower_index(slots.n16->keys, child_count, b);
+		size_type i = 0;
+		while (i < child_count && small_keys[i] < b)
+			++i;
+		return i;
+	}
+
+	// first position whose key is greater than b
+	size_type upper_index(unsigned char b) const
+	{
+		if (kind == node16)
+			return sorted16_upper_index(slots.n16->keys, child_count, b);
+		size_type i = 0;
+		while (i < child_count && small_keys[i] <= b)
+			++i;
+		return i;
+	}
+
+	// only for the indexed kinds
+	node_ptr at_index(unsigned b) const
+	{
+		if (kind == node48)
+		{
+			unsigned char slot = slots.n48->index[b];
+			return slot ? slots.n48->children[slot - 1] : NULL;
+		}
+		return slots.n256->children[b];
+	}
+
+	// first child at or after key byte from, only for the indexed kinds
+	node_ptr scan_up(int from) const
+	{
+		int b = kind == node48 ? first_nonzero_byte(slots.n48->index, from)
+			: first_set_bit(slots.n256->present, from);
+		return b < 0 ? NULL : at_index(b);
+	}
+
+	// last child at or before key byte from, only for the indexed kinds
+	node_ptr scan_down(int from) const
+	{
+		int b = kind == node48 ? last_nonzero_byte(slots.n48->index, from)
+			: last_set_bit(slots.n256->present, from);
+		return b < 0 ? NULL : at_index(b);
+	}
+
+	void mark_present(unsigned b)
+	{
+		slots.n256->present[b >> 5] |= boost::uint32_t(1) << (b & 31);
+	}
+
+	void clear_present(unsigned b)
+	{
+		slots.n256->present[b >> 5] &= ~(boost::uint32_t(1) << (b & 31));
+	}
+
+	void sorted_insert(unsigned char b, node_ptr child)
+	{
+		unsigned char *keys = sorted_keys();
+		node_ptr *children = sorted_children();
+		size_type i = lower_index(b);
+		std::copy_backward(keys + i, keys + child_count, keys + child_count + 1);
+		std::copy_backward(children + i, children + child_count, children + child_count + 1);
+		keys[i] = b;
+		children[i] = child;
+		++child_count;
+	}
+
+	void sorted_erase(unsigned char b)
+	{
+		unsigned char *keys = sorted_keys();
+		node_ptr *children = sorted_children();
+		size_type i = lower_index(b);
+		BOOST_ASSERT(i < child_count && keys[i] == b);
+		std::copy(keys + i + 1, keys + child_count, keys + i);
+		std::copy(children + i + 1, children + child_count, children + i);
+		--child_count;
+	}
+
+	template <typename Alloc>
+	void grow_to_16(Alloc& alloc)
+	{
+		node16_block *block = allocate_block<node16_block>(alloc, 1);
+		// the vector search reads all 16 key bytes
+		std::memset(block->keys, 0, sizeof(block->keys));
+		std::copy(small_keys, small_keys + child_count, block->keys);
+		std::copy(slots.small_children, slots.small_children + child_count, block->children);
+		slots.n16 = block;
+		kind = node16;
+	}
+
+	template <typename Alloc>
+	void grow_to_48(Alloc& alloc)
+	{
+		node48_block *block = allocate_block<node48_block>(alloc, 1);
+		node16_block *old = slots.n16;
+		std::memset(block->index, 0, sizeof(block->index));
+		for (size_type i = 0; i < child_count; ++i)
+		{
+			block->index[old->keys[i]] = static_cast<unsigned char>(i + 1);
+			block->children[i] = old->children[i];
+		}
+		deallocate_block(alloc, old, 1);
+		slots.n48 = block;
+		kind = node48;
+	}
+
+	template <typename Alloc>
+	void grow_to_256(Alloc& alloc)
+	{
+		node256_block *block = allocate_block<node256_block>(alloc, 1);
+		node48_block *old = slots.n48;
+		std::memset(block->present, 0, sizeof(block->present));
+		slots.n256 = block;
+		for (unsigned b = 0; b < 256; ++b)
+		{
+			block->children[b] = old->index[b] ? old->children[old->index[b] - 1] : NULL;
+			if (old->index[b])
+				mark_present(b);
+		}
+		deallocate_block(alloc, old, 1);
+		kind = node256;
+	}
+
+	template <typename Alloc>
+	void shrink_to_4(Alloc& alloc)
+	{
+		node16_block *old = slots.n16;
+		std::copy(old->keys, old->keys + child_count, small_keys);
+		std::copy(old->children, old->children + child_count, slots.small_children);
+		deallocate_block(alloc, old, 1);
+		kind = node4;
+	}
+
+	template <typename Alloc>
+	void shrink_to_16(Alloc& alloc)
+	{
+		node16_block *block = allocate_block<node16_block>(alloc, 1);
+		node48_block *old = slots.n48;
+		size_type n = 0;
+		std::memset(block->keys, 0, sizeof(block->keys));
+		for (unsigned b = 0; b < 256; ++b)
+		{
+			if (old->index[b])
+			{
+				block->keys[n] = static_cast<unsigned char>(b);
+				block->children[n] = old->children[old->index[b] - 1];
+				++n;
+			}
+		}
+		deallocate_block(alloc, old, 1);
+		slots.n16 = block;
+		kind = node16;
+	}
+
+	template <typename Alloc>
+	void shrink_to_48(Alloc& alloc)
+	{
+		node48_block *block = allocate_block<node48_block>(alloc, 1);
+		node256_block *old = slots.n256;
+		unsigned char n = 0;
+		std::memset(block->index, 0, sizeof(block->index));
+		for (unsigned b = 0; b < 256; ++b)
+		{
+			if (old->children[b] != NULL)
+			{
+				block->children[n] = old->children[b];
+				block->index[b] = ++n;
+			}
+		}
+		deallocate_block(alloc, old, 1);
+		slots.n48 = block;
+		kind = node48;
+	}
+
+public:
+	explicit adaptive_children() : kind(node4), child_count(0)
+	{
+	}
+
+	~adaptive_children()
+	{
+		BOOST_ASSERT(child_count == 0);
+	}
+
+	bool empty() const
+	{
+		return child_count == 0;
+	}
+
+	size_type size() const
+	{
+		return child_count;
+	}
+
+	node_ptr find(const key_type& key) const
+	{
+		unsigned char b = byte_key_index(key);
+		if (is_sorted_kind())
+		{
+			size_type i = lower_index(b);
+			return (i < child_count && sorted_keys()[i] == b) ? sorted_children()[i] : NULL;
+		}
+		return at_index(b);
+	}
+
+	// first child whose key is greater than key
+	node_ptr upper_bound(const key_type& key) const
+	{
+		unsigned char b = byte_key_index(key);
+		if (is_sorted_kind())
+		{
+			size_type i = upper_index(b);
+			return i < child_count ? sorted_children()[i] : NULL;
+		}
+		return scan_up(b + 1);
+	}
+
+	node_ptr front() const
+	{
+		if (child_count == 0)
+			return NULL;
+		return is_sorted_kind() ? sorted_children()[0] : scan_up(0);
+	}
+
+	node_ptr back() const
+	{
+		if (child_count == 0)
+			return NULL;
+		return is_sorted_kind() ? sorted_children()[child_count - 1] : scan_down(255);
+	}
+
+	node_ptr next(node_ptr child) const
+	{
+		return upper_bound(child->key);
+	}
+
+	node_ptr prev(node_ptr child) const
+	{
+		unsigned char b = byte_key_index(child->key);
+		if (is_sorted_kind())
+		{
+			size_type i = lower_index(b);
+			return i > 0 ? sorted_children()[i - 1] : NULL;
+		}
+		return scan_down(static_cast<int>(b) - 1);
+	}
+
+	template <typename Alloc>
+	void insert(node_ptr child, Alloc& alloc)
+	{
+		unsigned char b = byte_key_index(child->key);
+		switch (kind)
+		{
+		case node4:
+			if (child_count == 4)
+				break;
+			sorted_insert(b, child);
+			return;
+		case node16:
+			if (child_count == 16)
+				break;
+			sorted_insert(b, child);
+			return;
+		case node48:
+			if (child_count == 48)
+				break;
+			slots.n48->children[child_count] = child;
+			slots.n48->index[b] = static_cast<unsigned char>(++child_count);
+			return;
+		default:
+			slots.n256->children[b] = child;
+			mark_present(b);
+			++child_count;
+			return;
+		}
+
+		// the current kind is full
+		if (kind == node4)
+			grow_to_16(alloc);
+		else if (kind == node16)
+			grow_to_48(alloc);
+		else
+			grow_to_256(alloc);
+		insert(child, alloc);
+	}
+
+	template <typename Alloc>
+	void erase(node_ptr child, Alloc& alloc)
+	{
+		unsigned char b = byte_key_index(child->key);
+		switch (kind)
+		{
+		case node4:
+			sorted_erase(b);
+			break;
+		case node16:
+			sorted_erase(b);
+			if (child_count <= shrink16_size)
+				shrink_to_4(alloc);
+			break;
+		case node48: {
+			node48_block *block = slots.n48;
+			size_type slot = block->index[b] - 1;
+			size_type last = child_count - 1;
+			// keep the slots dense by moving the last one into the hole
+			if (slot != last)
+			{
+				block->children[slot] = block->children[last];
+				block->index[byte_key_index(block->children[slot]->key)] =
+					static_cast<unsigned char>(slot + 1);
+			}
+			block->index[b] = 0;
+			--child_count;
+			if (child_count <= shrink48_size)
+				shrink_to_16(alloc);
+			break;
+		}
+		default:
+			slots.n256->children[b] = NULL;
+			clear_present(b);
+			--child_count;
+			if (child_count <= shrink256_size)
+				shrink_to_48(alloc);
+			break;
+		}
+	}
+
+	// forget every child and block without freeing, for bulk released storage
+	void release()
+	{
+		kind = node4;
+		child_count = 0;
+	}
+};
+
+/*
+ * Other keys can only be compared with operator<, so children are kept
+ * as a sorted array of node pointers: four inline, then a heap array that
+ * grows from 16 slots by doubling.
+ */
+template <typename Key, typename Node>
+class adaptive_children<Key, Node, false> : private boost::noncopyable
+{
+public:
+	typedef Key key_type;
+	typedef Node node_type;
+	typedef node_type * node_ptr;
+	typedef std::size_t size_type;
+
+private:
+	enum {
+		small_capacity = 4,
+		min_heap_capacity = 16
+	};
+
+	size_type child_count;
+	// 0 while the children are stored inline
+	size_type capacity;
+	union {
+		node_ptr small_children[small_capacity];
+		node_ptr *heap;
+	} slots;
+
+	node_ptr const *children() const
+	{
+		return capacity == 0 ? slots.small_children : slots.heap;
+	}
+
+	node_ptr *children()
+	{
+		return capacity == 0 ? slots.small_children : slots.heap;
+	}
+
+	// first position whose key is not less than key
+	size_type lower_index(const key_type& key) const
+	{
+		node_ptr const *c = children();
+		size_type lo = 0, hi = child_count;
+		while (lo < hi)
+		{
+			size_type mid = (lo + hi) / 2;
+			if (c[mid]->key < key)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		return lo;
+	}
+
+	// first position whose key is greater than key
+	size_type upper_index(const key_type& key) const
+	{
+		node_ptr const *c = children();
+		size_type lo = 0, hi = child_count;
+		while (lo < hi)
+		{
+			size_type mid = (lo + hi) / 2;
+			if (key < c[mid]->key)
+				hi = mid;
+			else
+				lo = mid + 1;
+		}
+		return lo;
+	}
+
+	template <typename Alloc>
+	void reallocate(size_type new_capacity, Alloc& alloc)
+	{
+		node_ptr *old = children();
+		node_ptr *block = new_capacity == 0 ? slots.small_children :
+			allocate_block<node_ptr>(alloc, new_capacity);
+		if (block != old)
+			std::copy(old, old + child_count, block);
+		if (capacity != 0)
+			deallocate_block(alloc, old, capacity);
+		if (new_capacity != 0)
+			slots.heap = block;
+		capacity = new_capacity;
+	}
+
+public:
+	explicit adaptive_children() : child_count(0), capacity(0)
+	{
+	}
+
+	~adaptive_children()
+	{
+		BOOST_ASSERT(child_count == 0);
+	}
+
+	bool empty() const
+	{
+		return child_count == 0;
+	}
+
+	size_type size() const
+	{
+		return child_count;
+	}
+
+	node_ptr find(const key_type& key) const
+	{
+		size_type i = lower_index(key);
+		if (i < child_count && !(key < children()[i]->key))
+			return children()[i];
+		return NULL;
+	}
+
+	// first child whose key is greater than key
+	node_ptr upper_bound(const key_type& key) const
+	{
+		size_type i = upper_index(key);
+		return i < child_count ? children()[i] : NULL;
+	}
+
+	node_ptr front() const
+	{
+		return child_count ? children()[0] : NULL;
+	}
+
+	node_ptr back() const
+	{
+		return child_count ? children()[child_count - 1] : NULL;
+	}
+
+	node_ptr next(node_ptr child) const
+	{
+		return upper_bound(child->key);
+	}
+
+	node_ptr prev(node_ptr child) const
+	{
+		size_type i = lower_index(child->key);
+		return i > 0 ? children()[i - 1] : NULL;
+	}
+
+	template <typename Alloc>
+	void insert(node_ptr child, Alloc& alloc)
+	{
+		size_type cap = capacity == 0 ? size_type(small_capacity) : capacity;
+		if (child_count == cap)
+			reallocate(std::max(size_type(min_heap_capacity), 2 * capacity), alloc);
+		node_ptr *c = children();
+		size_type i = lower_index(child->key);
+		std::copy_backward(c + i, c + child_count, c + child_count + 1);
+		c[i] = child;
+		++child_count;
+	}
+
+	template <typename Alloc>
+	void erase(node_ptr child, Alloc& alloc)
+	{
+		node_ptr *c = children();
+		size_type i = lower_index(child->key);
+		BOOST_ASSERT(i < child_count && c[i] == child);
+		std::copy(c + i + 1, c + child_count, c + i);
+		--child_count;
+		if (capacity != 0 && child_count < small_capacity)
+			reallocate(0, alloc);
+		else if (capacity > min_heap_capacity && child_count <= capacity / 4)
+			reallocate(capacity / 2, alloc);
+	}
+
+	// forget every child and block without freeing, for bulk released storage
+	void release()
+	{
+		child_count = 0;
+		capacity = 0;
+	}
+};
+
+/*
+ * The children kept in an intrusive red-black tree, linked through a hook
+ * in every node. Finding the next sibling is constant time, but every
+ * step of a lookup chases pointers through the tree.
+ */
+typedef boost::intrusive::set_base_hook<
+	boost::intrusive::optimize_size<true>,
+	boost::intrusive::link_mode<boost::intrusive::normal_link>
+> rbtree_children_hook;
+
+struct no_children_hook {
+};
+
+template <typename Key, typename Node>
+class rbtree_children : private boost::noncopyable
+{
+public:
+	typedef Key key_type;
+	typedef Node node_type;
+	typedef node_type * node_ptr;
+	typedef std::size_t size_type;
+
+private:
+	struct node_compare {
+		bool operator () (const node_type& a, const node_type& b) const {
+			return a.key < b.key;
+		}
+
+		bool operator () (const key_type& a, const node_type& b) const {
+			return a < b.key;
+		}
+
+		bool operator () (const node_type& a, const key_type& b) const {
+			return a.key < b;
+		}
+	};
+
+	typedef boost::intrusive::set<node_type,
+		boost::intrusive::compare<node_compare>,
+		boost::intrusive::constant_time_size<false>
+	> set_type;
+	typedef typename set_type::iterator set_iterator;
+
+	mutable set_type children;
+
+public:
+	bool empty() const
+	{
+		return children.empty();
+	}
+
+	size_type size() const
+	{
+		return children.size();
+	}
+
+	node_ptr find(const key_type& key) const
+	{
+		set_iterator it = children.find(key, node_compare());
+		return it == children.end() ? NULL : &(*it);
+	}
+
+	node_ptr upper_bound(const key_type& key) const
+	{
+		set_iterator it = children.upper_bound(key, node_compare());
+		return it == children.end() ? NULL : &(*it);
+	}
+
+	node_ptr front() const
+	{
+		return children.empty() ? NULL : &(*children.begin());
+	}
+
+	node_ptr back() const
+	{
+		return children.empty() ? NULL : &(*children.rbegin());
+	}
+
+	node_ptr next(node_ptr child) const
+	{
+		set_iterator it = set_type::s_iterator_to(*child);
+		++it;
+		return it == children.end() ? NULL : &(*it);
+	}
+
+	node_ptr prev(node_ptr child) const
+	{
+		set_iterator it = set_type::s_iterator_to(*child);
+		if (it == children.begin())
+			return NULL;
+		--it;
+		return &(*it);
+	}
+
+	template <typename Alloc>
+	void insert(node_ptr child, Alloc&)
+	{
+		children.insert(*child);
+	}
+
+	template <typename Alloc>
+	void erase(node_ptr child, Alloc&)
+	{
+		children.erase(set_type::s_iterator_to(*child));
+	}
+
+	// unlink every child, constant time with normal_link hooks
+	void release()
+	{
+		children.clear();
+	}
+};
+
+/*
+ * The children kept in a sorted contiguous array, with the keys copied
+ * next to the child pointers so that a binary search does not touch the
+ * children themselves.
+ */
+template <typename Key, typename Node>
+class vector_children : private boost::noncopyable
+{
+public:
+	typedef Key key_type;
+	typedef Node node_type;
+	typedef node_type * node_ptr;
+	typedef std::size_t size_type;
+
+private:
+	enum { min_capacity = 4 };
+
+	key_type *keys;
+	node_ptr *children;
+	size_type child_count;
+	size_type capacity;
+
+	// first position whose key is not less than key
+	size_type lower_index(const key_type& key) const
+	{
+		size_type lo = 0, hi = child_count;
+		while (lo < hi)
+		{
+			size_type mid = (lo + hi) / 2;
+			if (keys[mid] < key)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		return lo;
+	}
+
+	// first position whose key is greater than key
+	size_type upper_index(const key_type& key) const
+	{
+		size_type lo = 0, hi = child_count;
+		while (lo < hi)
+		{
+			size_type mid = (lo + hi) / 2;
+			if (key < keys[mid])
+				hi = mid;
+			else
+				lo = mid + 1;
+		}
+		return lo;
+	}
+
+	// keys are moved by copy construction, the old ones are destroyed
+	template <typename Alloc>
+	void reallocate(size_type new_capacity, Alloc& alloc)
+	{
+		key_type *new_keys = NULL;
+		node_ptr *new_children = NULL;
+		if (new_capacity != 0)
+		{
+			new_keys = allocate_block<key_type>(alloc, new_capacity);
+			new_children = allocate_block<node_ptr>(alloc, new_capacity);
+			for (size_type i = 0; i < child_count; ++i)
+				new(new_keys + i) key_type(keys[i]);
+			std::copy(children, children + child_count, new_children);
+		}
+		if (capacity != 0)
+		{
+			for (size_type i = 0; i < child_count; ++i)
+				keys[i].~key_type();
+			deallocate_block(alloc, keys, capacity);
+			deallocate_block(alloc, children, capacity);
+		}
+		keys = new_keys;
+		children = new_children;
+		capacity = new_capacity;
+	}
+
+public:
+	explicit vector_children() : keys(NULL), children(NULL), child_count(0), capacity(0)
+	{
+	}
+
+	~vector_children()
+	{
+		BOOST_ASSERT(capacity == 0);
+	}
+
+	bool empty() const
+	{
+		return child_count == 0;
+	}
+
+	size_type size() const
+	{
+		return child_count;
+	}
+
+	node_ptr find(const key_type& key) const
+	{
+		size_type i = lower_index(key);
+		if (i < child_count && !(key < keys[i]))
+			return children[i];
+		return NULL;
+	}
+
+	node_ptr upper_bound(const key_type& key) const
+	{
+		size_type i = upper_index(key);
+		return i < child_count ? children[i] : NULL;
+	}
+
+	node_ptr front() const
+	{
+		return child_count ? children[0] : NULL;
+	}
+
+	node_ptr back() const
+	{
+		return child_count ? children[child_count - 1] : NULL;
+	}
+
+	node_ptr next(node_ptr child) const
+	{
+		return upper_bound(child->key);
+	}
+
+	node_ptr prev(node_ptr child) const
+	{
+		size_type i = lower_index(child->key);
+		return i > 0 ? children[i - 1] : NULL;
+	}
+
+	template <typename Alloc>
+	void insert(node_ptr child, Alloc& alloc)
+	{
+		if (child_count == capacity)
+			reallocate(std::max(size_type(min_capacity), 2 * capacity), alloc);
+		size_type i = lower_index(child->key);
+		if (i == child_count)
+		{
+			new(keys + child_count) key_type(child->key);
+		} else {
+			new(keys + child_count) key_type(keys[child_count - 1]);
+			std::copy_backward(keys + i, keys + child_count - 1, keys + child_count);
+			keys[i] = child->key;
+		}
+		std::copy_backward(children + i, children + child_count, children + child_count + 1);
+		children[i] = child;
+		++child_count;
+	}
+
+	template <typename Alloc>
+	void erase(node_ptr child, Alloc& alloc)
+	{
+		size_type i = lower_index(child->key);
+		BOOST_ASSERT(i < child_count && children[i] == child);
+		std::copy(keys + i + 1, keys + child_count, keys + i);
+		std::copy(children + i + 1, children + child_count, children + i);
+		--child_count;
+		keys[child_count].~key_type();
+		if (child_count == 0)
+			reallocate(0, alloc);
+		else if (capacity > min_capacity && child_count <= capacity / 4)
+			reallocate(capacity / 2, alloc);
+	}
+
+	// forget every child and block without freeing, for bulk released storage
+	void release()
+	{
+		keys = NULL;
+		children = NULL;
+		child_count = 0;
+		capacity = 0;
+	}
+};
+
+/*
+ * The children kept in a table indexed by KeyIndex, allocated with the
+ * first child. Lookups are a single array access, which pays off for
+ * small alphabets; a byte indexed table costs 256 pointers per node.
+ */
+template <typename Key, typename Node, typename KeyIndex>
+class indexed_children : private boost::noncopyable
+{
+public:
+	typedef Key key_type;
+	typedef Node node_type;
+	typedef node_type * node_ptr;
+	typedef std::size_t size_type;
+
+private:
+	node_ptr *children;
+	size_type child_count;
+
+	static size_type index_of(const key_type& key)
+	{
+		return KeyIndex()(key);
+	}
+
+	node_ptr scan_up(size_type from) const
+	{
+		for (size_type i = from; i < KeyIndex::size; ++i)
+		{
+			if (children[i] != NULL)
+				return children[i];
+		}
+		return NULL;
+	}
+
+	node_ptr scan_down(size_type from) const
+	{
+		for (size_type i = from; i > 0; --i)
+		{
+			if (children[i - 1] != NULL)
+				return children[i - 1];
+		}
+		return NULL;
+	}
+
+public:
+	explicit indexed_children() : children(NULL), child_count(0)
+	{
+	}
+
+	~indexed_children()
+	{
+		BOOST_ASSERT(children == NULL);
+	}
+
+	bool empty() const
+	{
+		return child_count == 0;
+	}
+
+	size_type size() const
+	{
+		return child_count;
+	}
+
+	node_ptr find(const key_type& key) const
+	{
+		size_type i = index_of(key);
+		return (child_count && i < KeyIndex::size) ? children[i] : NULL;
+	}
+
+	node_ptr upper_bound(const key_type& key) const
+	{
+		size_type i = index_of(key);
+		return (child_count && i < KeyIndex::size) ? scan_up(i + 1) : NULL;
+	}
+
+	node_ptr front() const
+	{
+		return child_count ? scan_up(0) : NULL;
+	}
+
+	node_ptr back() const
+	{
+		return child_count ? scan_down(KeyIndex::size) : NULL;
+	}
+
+	node_ptr next(node_ptr child) const
+	{
+		return scan_up(index_of(child->key) + 1);
+	}
+
+	node_ptr prev(node_ptr child) const
+	{
+		return scan_down(index_of(child->key));
+	}
+
+	// whether key has a slot in the table; the trie checks this before
+	// it creates any node of a key
+	static bool accepts(const key_type& key)
+	{
+		return index_of(key) < KeyIndex::size;
+	}
+
+	template <typename Alloc>
+	void insert(node_ptr child, Alloc& alloc)
+	{
+		size_type i = index_of(child->key);
+		BOOST_ASSERT(i < KeyIndex::size);
+		if (children == NULL)
+		{
+			children = allocate_block<node_ptr>(alloc, KeyIndex::size);
+			std::fill(children, children + KeyIndex::size, node_ptr(NULL));
+		}
+		children[i] = child;
+		++child_count;
+	}
+
+	template <typename Alloc>
+	void erase(node_ptr child, Alloc& alloc)
+	{
+		children[index_of(child->key)] = NULL;
+		if (--child_count == 0)
+		{
+			deallocate_block(alloc, children, KeyIndex::size);
+			children = NULL;
+		}
+	}
+
+	// forget every child and block without freeing, for bulk released storage
+	void release()
+	{
+		children = NULL;
+		child_count = 0;
+	}
+};
+
+// whether a children container may refuse a key, see accepts() above
+template <typename Children>
+struct children_reject_keys : boost::false_type
+{
+};
+
+template <typename Key, typename Node, typename KeyIndex>
+struct children_reject_keys<indexed_children<Key, Node, KeyIndex> > : boost::true_type
+{
+};
+
+} /* detail */
+
+/*
+ * Child policies select the container that holds the children of every
+ * trie node. A policy provides the base hook the nodes derive from and
+ * the container type for a given key and node type.
+ */
+
+// adaptive node layouts, the default
+struct adaptive_children_policy {
+	typedef detail::no_children_hook hook_type;
+
+	template <typename Key, typename Node>
+	struct children {
+		typedef detail::adaptive_children<Key, Node> type;
+	};
+};
+
+// one intrusive red-black tree per node, the original layout
+struct rbtree_children_policy {
+	typedef detail::rbtree_children_hook hook_type;
+
+	template <typename Key, typename Node>
+	struct children {
+		typedef detail::rbtree_children<Key, Node> type;
+	};
+};
+
+// one sorted contiguous array of keys and children per node
+struct vector_children_policy {
+	typedef detail::no_children_hook hook_type;
+
+	template <typename Key, typename Node>
+	struct children {
+		typedef detail::vector_children<Key, Node> type;
+	};
+};
+
+// the default KeyIndex of indexed_children_policy, for byte keys
+struct byte_key_index {
+	static const std::size_t size = 256;
+
+	template <typename Key>
+	std::size_t operator () (const Key& key) const
+	{
+		// wider keys would share the slot of their low byte
+		BOOST_STATIC_ASSERT_MSG(detail::is_byte_key<Key>::value,
+				"byte_key_index needs a one byte integral key, give indexed_children_policy a KeyIndex");
+		return detail::byte_key_index(key);
+	}
+};
+
+/*
+ * One table of KeyIndex::size children per node. KeyIndex maps a key to
+ * its slot; the mapping has to preserve the order of operator<, e.g.
+ * A, C, G, T to 0, 1, 2, 3 for DNA. Inserting a key with an element
+ * mapped outside of the table throws std::out_of_range and leaves the
+ * trie as it was.
+ */
+template <typename KeyIndex = byte_key_index>
+struct indexed_children_policy {
+	typedef detail::no_children_hook hook_type;
+
+	template <typename Key, typename Node>
+	struct children {
+		typedef detail::indexed_children<Key, Node, KeyIndex> type;
+	};
+};
+
+} /* tries */
+} /* boost */
+
+#endif
@@ -0,0 +1,155 @@
+#ifndef BOOST_TRIE_CURSOR_HPP
+#define BOOST_TRIE_CURSOR_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <vector>
+#include <boost/trie/detail/trie_node.hpp>
+#include <boost/type_traits/remove_const.hpp>
+#include <boost/type_traits/add_reference.hpp>
+#include <boost/type_traits/integral_constant.hpp>
+
+namespace boost { namespace tries {
+
+namespace detail {
+
+/*
+ * Forward cursor over a trie that keeps the key of its position in a
+ * buffer, pushing and popping one element per edge it moves along. A full
+ * walk touches every node a constant number of times and, once the buffer
+ * has reached the depth of the trie, allocates nothing.
+ *
+ * key() is a reference to that buffer, valid until the cursor moves.
+ * Unlike the iterators the cursor goes forward only, and any change to
+ * the trie invalidates it.
+ */
+template <typename Key, typename Value, bool isMultiValue,
+	typename ChildPolicy = adaptive_children_policy>
+class trie_cursor
+{
+public:
+	typedef Key key_type;
+	typedef typename boost::remove_const<Value>::type non_const_value_type;
+	typedef typename boost::add_reference<Value>::type reference;
+	typedef trie_node<Key, non_const_value_type, isMultiValue, ChildPolicy> trie_node_type;
+	typedef trie_node_type* trie_node_ptr;
+	typedef std::size_t size_type;
+	typedef boost::integral_constant<bool, isMultiValue> is_multi;
+
+private:
+	trie_node_ptr tnode;
+	// index of the value in a multi value node, counting down
+	size_type vindex;
+	std::vector<key_type> key_path;
+
+	static size_type first_index(trie_node_ptr node, boost::true_type)
+	{
+		return node->newest_index();
+	}
+
+	static size_type first_index(trie_node_ptr, boost::false_type)
+	{
+		return 0;
+	}
+
+	reference value_at(boost::true_type) const
+	{
+		return tnode->values[vindex];
+	}
+
+	reference value_at(boost::false_type) const
+	{
+		return tnode->value;
+	}
+
+	// from tnode down the first children to the first node with a value
+	void descend()
+	{
+		while (tnode->no_value())
+		{
+			tnode = tnode->children.front();
+			key_path.push_back(tnode->key_elem());
+		}
+		vindex = first_index(tnode, is_multi());
+	}
+
+public:
+	explicit trie_cursor() : tnode(0), vindex(0)
+	{
+	}
+
+	// start at node, building its key once
+	explicit trie_cursor(trie_node_ptr node) : tnode(node), vindex(0)
+	{
+		size_type depth = 0;
+		for (trie_node_ptr cur = node; cur->parent != NULL; cur = cur->parent)
+			++depth;
+		key_path.resize(depth);
+		for (trie_node_ptr cur = node; cur->parent != NULL; cur = cur->parent)
+			key_path[--depth] = cur->key_elem();
+		if (tnode->parent != NULL)
+			vindex = first_index(tnode, is_multi());
+	}
+
+	bool at_end() const
+	{
+		return tnode->parent == NULL;
+	}
+
+	const std::vector<key_type>& key() const
+	{
+		return key_path;
+	}
+
+	reference value() const
+	{
+		return value_at(is_multi());
+	}
+
+	trie_node_ptr node() const
+	{
+		return tnode;
+	}
+
+	trie_cursor& operator++()
+	{
+		if (at_end())
+			return *this;
+		if (vindex > 0)
+		{
+			--vindex;
+			return *this;
+		}
+		if (!tnode->children.empty())
+		{
+			tnode = tnode->children.front();
+			key_path.push_back(tnode->key_elem());
+			descend();
+			return *this;
+		}
+		// climb to the first ancestor with a next sibling
+		while (tnode->parent != NULL)
+		{
+			trie_node_ptr sibling = tnode->parent->children.next(tnode);
+			key_path.pop_back();
+			if (sibling != NULL)
+			{
+				tnode = sibling;
+				key_path.push_back(tnode->key_elem());
+				descend();
+				return *this;
+			}
+			tnode = tnode->parent;
+		}
+		vindex = 0;
+		return *this;
+	}
+};
+
+} /* detail */
+} /* tries */
+} /* boost */
+
+#endif
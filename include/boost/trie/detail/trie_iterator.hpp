@@ -14,11 +14,12 @@ namespace boost {  namespace tries {
 
 namespace detail {
 
-template<typename Key, typename Value, bool isMultiValue, typename Enable = void>
+template<typename Key, typename Value, bool isMultiValue,
+	typename ChildPolicy = adaptive_children_policy, typename Enable = void>
 struct trie_iterator;
 
-template<typename Key, typename Value>
-struct trie_iterator<Key, Value, true>
+template<typename Key, typename Value, typename ChildPolicy>
+struct trie_iterator<Key, Value, true, ChildPolicy>
 {
 	typedef std::bidirectional_iterator_tag iterator_category;
 	typedef Key key_type;
@@ -27,40 +28,33 @@ struct trie_iterator<Key, Value, true>
 	typedef std::pair<std::vector<key_type>, Value&>* pointer;
 	typedef ptrdiff_t difference_type;
 	typedef typename boost::remove_const<Value>::type non_const_value_type;
-	typedef trie_iterator<Key, non_const_value_type, true> iterator;
-	typedef trie_iterator<Key, Value, true> iter_type;
+	typedef trie_iterator<Key, non_const_value_type, true, ChildPolicy> iterator;
+	typedef trie_iterator<Key, Value, true, ChildPolicy> iter_type;
 	typedef iter_type self;
-	typedef trie_iterator<Key, const Value, true> const_iterator;
-	typedef trie_node<Key, non_const_value_type, true> trie_node_type;
+	typedef trie_iterator<Key, const Value, true, ChildPolicy> const_iterator;
+	typedef trie_node<Key, non_const_value_type, true, ChildPolicy> trie_node_type;
 	typedef trie_node_type* trie_node_ptr;
-	typedef value_list_node<Key, non_const_value_type> value_node_type;
-	typedef value_node_type* value_node_ptr;
 	typedef size_t size_type;
 	typedef typename trie_node_type::children_type node_children_type;
-	typedef typename node_children_type::iterator children_iterator;
-	typedef typename node_children_type::reverse_iterator children_reverse_iterator;
 
 	trie_node_ptr tnode;
-	value_node_ptr vnode;
+	// index in the values of tnode; it counts down, the newest value first
+	size_type vindex;
 
 public:
-	explicit trie_iterator() : tnode(0), vnode(0)
+	explicit trie_iterator() : tnode(0), vindex(0)
 	{
 	}
 
-	trie_iterator(trie_node_ptr x) : tnode(x), vnode(x->value_list_header)
+	trie_iterator(trie_node_ptr x) : tnode(x), vindex(x->newest_index())
 	{
 	}
 
-	trie_iterator(value_node_ptr x) : tnode(x->node_in_trie), vnode(x)
+	explicit trie_iterator(trie_node_ptr t, size_type v) : tnode(t), vindex(v)
 	{
 	}
 
-	explicit trie_iterator(trie_node_ptr t, value_node_ptr v) : tnode(t), vnode(v)
-	{
-	}
-
-	trie_iterator(const iterator &it) : tnode(it.tnode), vnode(it.vnode)
+	trie_iterator(const iterator &it) : tnode(it.tnode), vindex(it.vindex)
 	{
 	}
 
@@ -82,7 +76,7 @@ public:
 
 	reference operator*() const
 	{
-		return reference(get_key(), vnode->value);
+		return reference(get_key(), tnode->values[vindex]);
 	}
 
 	pointer operator->() const
@@ -92,26 +86,26 @@ public:
 
 	bool operator==(const trie_iterator& other) const
 	{
-		return tnode == other.tnode && vnode == other.vnode;
+		return tnode == other.tnode && vindex == other.vindex;
 	}
 
 	bool operator!=(const trie_iterator& other) const
 	{
-		return tnode != other.tnode || vnode != other.vnode;
+		return tnode != other.tnode || vindex != other.vindex;
 	}
 
 	void go_up_forward() {
-		typename node_children_type::iterator it;
+		trie_node_ptr sibling;
 		tnode = tnode->parent;
-		vnode = tnode->value_list_header;
+		vindex = tnode->newest_index();
 		while (tnode->parent != NULL) {
-			it = ++(node_children_type::s_iterator_to(*tnode));
-			if (it != tnode->parent->children.end()) {
-				tnode = &(*it);
+			sibling = tnode->parent->children.next(tnode);
+			if (sibling != NULL) {
+				tnode = sibling;
 				if (tnode->no_value())
 					go_down_forward();
 				else
-					vnode = tnode->value_list_header;
+					vindex = tnode->newest_index();
 				break;
 			}
 			tnode = tnode->parent;
@@ -122,31 +116,30 @@ public:
 		if (tnode->children.empty())
 			return false;
 		do  {
-			tnode = &(*(tnode->children.begin()));
+			tnode = tnode->children.front();
 		} while (!tnode->children.empty() && tnode->no_value());
-		vnode = tnode->value_list_header;
+		vindex = tnode->newest_index();
 		return true;
 	}
 
 	void go_down_backward() {
 		if (tnode->children.empty()) {
-			vnode = tnode->value_list_header;
+			vindex = tnode->newest_index();
 			return;
 		}
 		do {
-			tnode = &(*(tnode->children.rbegin()));
+			tnode = tnode->children.back();
 		} while(!tnode->children.empty());
-		vnode = tnode->value_list_tail;
+		vindex = 0;
 	}
 
 	void go_up_backward() {
-		typename node_children_type::iterator it;
+		trie_node_ptr sibling;
 		tnode = tnode->parent;
 		while (tnode->parent && tnode->no_value()) {
-			it = node_children_type::s_iterator_to(*tnode);
-			if (it != tnode->parent->children.begin()) {
-				--it;
-				tnode = &(*it);
+			sibling = tnode->parent->children.prev(tnode);
+			if (sibling != NULL) {
+				tnode = sibling;
 				go_down_backward();
 				break;
 			}
@@ -160,25 +153,19 @@ public:
 	{
 		if (tnode->parent == NULL)
 			return;
-		/*
-		 *First check is usefull when iterator is used for erasure
-		 *by the clear function. In that case vnode gets invalided
-		 *and the vnode->next would generate memory error
-		 */
-		if (!tnode->no_value() && vnode->next != NULL) {
-			vnode = static_cast<value_node_ptr>(vnode->next);
+		if (!tnode->no_value() && vindex > 0) {
+			--vindex;
 			return;
 		}
 
 		if (!go_down_forward()) {
-			typename node_children_type::iterator it =
-				++(node_children_type::s_iterator_to(*tnode));
-			if (it != tnode->parent->children.end()) {
-				tnode = &(*it);
+			trie_node_ptr sibling = tnode->parent->children.next(tnode);
+			if (sibling != NULL) {
+				tnode = sibling;
 				if (tnode->no_value()) {
 					go_down_forward();
 				} else {
-					vnode = tnode->value_list_header;
+					vindex = tnode->newest_index();
 				}
 			} else {
 				go_up_forward();
@@ -192,16 +179,15 @@ public:
 		 *no_value() check is useful when iterator is on the root node
 		 *and value may be NULL. This happens at rbegin() call
 		 */
-		if (!tnode->no_value() && vnode->pred != NULL) {
-			vnode = static_cast<value_node_ptr>(vnode->pred);
+		if (!tnode->no_value() && vindex + 1 < tnode->count()) {
+			++vindex;
 			return;
 		}
 
-		children_iterator it = node_children_type::s_iterator_to(*tnode);
 		if (tnode->parent) {
-			if (it != tnode->parent->children.begin()) {
-				--it;
-				tnode = &(*it);
+			trie_node_ptr sibling = tnode->parent->children.prev(tnode);
+			if (sibling != NULL) {
+				tnode = sibling;
 				go_down_backward();
 			} else {
 				go_up_backward();
@@ -215,23 +201,13 @@ public:
 	   Delegate erasure of iterator to iterator instead of trie
 	   in order to handle specializations that do not have a value list
 	*/
-	bool __erase_self_value_node() {
-		value_node_ptr vp = this->vnode;
-		trie_node_ptr trie_node = this->tnode;
-		if (vp->next == NULL && vp->pred == NULL)
+	template<typename Allocator>
+	bool __erase_self_value_node(Allocator& alloc) {
+		if (tnode->count() == 1)
 			return true;
-		 if (vp->pred) {
-			 vp->pred->next = vp->next;
-		 } else {
-			 trie_node->value_list_header = static_cast<value_node_ptr>(vp->next);
-		 }
-		 if (vp->next) {
-			 vp->next->pred = vp->pred;
-		 } else {
-			trie_node->value_list_tail = static_cast<value_node_ptr>(vp->pred);
-		 }
-		 delete vp;
-		 return false;
+		// only newer values move, an iterator already advanced stays valid
+		tnode->erase_value(vindex, alloc);
+		return false;
 	}
 
 	self& operator++()
@@ -261,8 +237,8 @@ public:
 	}
 };
 
-template<typename Key, typename Value>
-struct trie_iterator<Key, Value, false,
+template<typename Key, typename Value, typename ChildPolicy>
+struct trie_iterator<Key, Value, false, ChildPolicy,
 	typename boost::disable_if<boost::is_same<typename boost::remove_const<Value>::type, void> >::type>
 {
 	typedef std::bidirectional_iterator_tag iterator_category;
@@ -272,16 +248,14 @@ struct trie_iterator<Key, Value, false,
 	typedef std::pair<std::vector<key_type>, Value&>* pointer;
 	typedef ptrdiff_t difference_type;
 	typedef typename boost::remove_const<Value>::type non_const_value_type;
-	typedef trie_iterator<Key, non_const_value_type, false> iterator;
-	typedef trie_iterator<Key, Value, false> iter_type;
+	typedef trie_iterator<Key, non_const_value_type, false, ChildPolicy> iterator;
+	typedef trie_iterator<Key, Value, false, ChildPolicy> iter_type;
 	typedef iter_type self;
-	typedef trie_iterator<Key, const Value, false> const_iterator;
-	typedef trie_node<Key, non_const_value_type, false> trie_node_type;
+	typedef trie_iterator<Key, const Value, false, ChildPolicy> const_iterator;
+	typedef trie_node<Key, non_const_value_type, false, ChildPolicy> trie_node_type;
 	typedef trie_node_type* trie_node_ptr;
 	typedef size_t size_type;
 	typedef typename trie_node_type::children_type node_children_type;
-	typedef typename node_children_type::iterator children_iterator;
-	typedef typename node_children_type::reverse_iterator children_reverse_iterator;
 
 	trie_node_ptr tnode;
 
@@ -318,7 +292,8 @@ public:
 	   This iterator doesn't have any value node. If erase it's called on it
 	   the coresponding node in trie should be removed too
 	*/
-	bool __erase_self_value_node() {
+	template<typename Allocator>
+	bool __erase_self_value_node(Allocator&) {
 		return true;
 	}
 
@@ -343,12 +318,12 @@ public:
 	}
 
 	void go_up_forward() {
-		typename node_children_type::iterator it;
+		trie_node_ptr sibling;
 		tnode = tnode->parent;
 		while (tnode->parent != NULL) {
-			it = ++(node_children_type::s_iterator_to(*tnode));
-			if (it != tnode->parent->children.end()) {
-				tnode = &(*it);
+			sibling = tnode->parent->children.next(tnode);
+			if (sibling != NULL) {
+				tnode = sibling;
 				if (tnode->no_value())
 					go_down_forward();
 				break;
@@ -361,7 +336,7 @@ public:
 		if (tnode->children.empty())
 			return false;
 		do  {
-				tnode = &(*(tnode->children.begin()));
+				tnode = tnode->children.front();
 		} while (!tnode->children.empty() && tnode->no_value());
 		return true;
 	}
@@ -370,18 +345,17 @@ public:
 		if (tnode->children.empty())
 			return;
 		do {
-			tnode = &(*(tnode->children.rbegin()));
+			tnode = tnode->children.back();
 		} while(!tnode->children.empty());
 	}
 
 	void go_up_backward() {
-		typename node_children_type::iterator it;
+		trie_node_ptr sibling;
 		tnode = tnode->parent;
 		while (tnode->parent && tnode->no_value()) {
-			it = node_children_type::s_iterator_to(*tnode);
-			if (it != tnode->parent->children.begin()) {
-				--it;
-				tnode = &(*it);
+			sibling = tnode->parent->children.prev(tnode);
+			if (sibling != NULL) {
+				tnode = sibling;
 				go_down_backward();
 				break;
 			}
@@ -397,10 +371,9 @@ public:
 			return;
 
 		if (!go_down_forward()) {
-			typename node_children_type::iterator it =
-				++(node_children_type::s_iterator_to(*tnode));
-			if (it != tnode->parent->children.end()) {
-				tnode = &(*it);
+			trie_node_ptr sibling = tnode->parent->children.next(tnode);
+			if (sibling != NULL) {
+				tnode = sibling;
 				if (tnode->no_value()) {
 					go_down_forward();
 				}
@@ -412,11 +385,10 @@ public:
 
 	void trie_node_decrement()
 	{
-		children_iterator it = node_children_type::s_iterator_to(*tnode);
 		if (tnode->parent) {
-			if (it != tnode->parent->children.begin()) {
-				--it;
-				tnode = &(*it);
+			trie_node_ptr sibling = tnode->parent->children.prev(tnode);
+			if (sibling != NULL) {
+				tnode = sibling;
 				go_down_backward();
 			} else {
 				go_up_backward();
@@ -453,8 +425,8 @@ public:
 	}
 };
 
-template<typename Key, typename Value>
-struct trie_iterator<Key, Value, false,
+template<typename Key, typename Value, typename ChildPolicy>
+struct trie_iterator<Key, Value, false, ChildPolicy,
 	typename boost::enable_if<boost::is_same<typename boost::remove_const<Value>::type, void> >::type>
 {
 	typedef std::bidirectional_iterator_tag iterator_category;
@@ -463,16 +435,14 @@ struct trie_iterator<Key, Value, false,
 	typedef std::vector<key_type> reference;
 	typedef std::vector<key_type>* pointer;
 	typedef ptrdiff_t difference_type;
-	typedef trie_iterator<Key, void, false> iterator;
-	typedef trie_iterator<Key, Value, false> iter_type;
+	typedef trie_iterator<Key, void, false, ChildPolicy> iterator;
+	typedef trie_iterator<Key, Value, false, ChildPolicy> iter_type;
 	typedef iter_type self;
-	typedef trie_iterator<Key, const void, false> const_iterator;
-	typedef trie_node<Key, void, false> trie_node_type;
+	typedef trie_iterator<Key, const void, false, ChildPolicy> const_iterator;
+	typedef trie_node<Key, void, false, ChildPolicy> trie_node_type;
 	typedef trie_node_type* trie_node_ptr;
 	typedef size_t size_type;
 	typedef typename trie_node_type::children_type node_children_type;
-	typedef typename node_children_type::iterator children_iterator;
-	typedef typename node_children_type::reverse_iterator children_reverse_iterator;
 
 	trie_node_ptr tnode;
 
@@ -509,7 +479,8 @@ public:
 	   This iterator doesn't have any value node. If erase it's called on it
 	   the coresponding node in trie should be removed too
 	*/
-	bool __erase_self_value_node() {
+	template<typename Allocator>
+	bool __erase_self_value_node(Allocator&) {
 		return true;
 	}
 
@@ -534,12 +505,12 @@ public:
 	}
 
 	void go_up_forward() {
-		typename node_children_type::iterator it;
+		trie_node_ptr sibling;
 		tnode = tnode->parent;
 		while (tnode->parent != NULL) {
-			it = ++(node_children_type::s_iterator_to(*tnode));
-			if (it != tnode->parent->children.end()) {
-				tnode = &(*it);
+			sibling = tnode->parent->children.next(tnode);
+			if (sibling != NULL) {
+				tnode = sibling;
 				if (tnode->no_value())
 					go_down_forward();
 				break;
@@ -552,7 +523,7 @@ public:
 		if (tnode->children.empty())
 			return false;
 		do  {
-				tnode = &(*(tnode->children.begin()));
+				tnode = tnode->children.front();
 		} while (!tnode->children.empty() && tnode->no_value());
 		return true;
 	}
@@ -561,18 +532,17 @@ public:
 		if (tnode->children.empty())
 			return;
 		do {
-			tnode = &(*(tnode->children.rbegin()));
+			tnode = tnode->children.back();
 		} while(!tnode->children.empty());
 	}
 
 	void go_up_backward() {
-		typename node_children_type::iterator it;
+		trie_node_ptr sibling;
 		tnode = tnode->parent;
 		while (tnode->parent && tnode->no_value()) {
-			it = node_children_type::s_iterator_to(*tnode);
-			if (it != tnode->parent->children.begin()) {
-				--it;
-				tnode = &(*it);
+			sibling = tnode->parent->children.prev(tnode);
+			if (sibling != NULL) {
+				tnode = sibling;
 				go_down_backward();
 				break;
 			}
@@ -588,10 +558,9 @@ public:
 			return;
 
 		if (!go_down_forward()) {
-			typename node_children_type::iterator it =
-				++(node_children_type::s_iterator_to(*tnode));
-			if (it != tnode->parent->children.end()) {
-				tnode = &(*it);
+			trie_node_ptr sibling = tnode->parent->children.next(tnode);
+			if (sibling != NULL) {
+				tnode = sibling;
 				if (tnode->no_value()) {
 					go_down_forward();
 				}
@@ -603,11 +572,10 @@ public:
 
 	void trie_node_decrement()
 	{
-		children_iterator it = node_children_type::s_iterator_to(*tnode);
 		if (tnode->parent) {
-			if (it != tnode->parent->children.begin()) {
-				--it;
-				tnode = &(*it);
+			trie_node_ptr sibling = tnode->parent->children.prev(tnode);
+			if (sibling != NULL) {
+				tnode = sibling;
 				go_down_backward();
 			} else {
 				go_up_backward();
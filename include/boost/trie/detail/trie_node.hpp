@@ -8,124 +8,47 @@
 #include <map>
 #include <vector>
 #include <boost/utility.hpp>
-#include <boost/intrusive/set.hpp>
+#include <boost/trie/detail/trie_children.hpp>
+#include <boost/trie/detail/value_vector.hpp>
 #include <memory>
 
 namespace boost { namespace tries {
 
 namespace detail {
 
-template <typename Key, typename Value, bool isMultiValue>
+template <typename Key, typename Value, bool isMultiValue,
+	typename ChildPolicy = adaptive_children_policy>
 struct trie_node;
 
-struct list_node_base : protected boost::noncopyable {
-	typedef list_node_base *base_ptr;
-	base_ptr pred;
-	base_ptr next;
-
-	list_node_base() : pred(0), next(0)
-	{}
-};
-
-template <typename Key, typename Value>
-struct value_list_node : public list_node_base {
-	typedef Key key_type;
-	typedef Value value_type;
-	typedef trie_node<key_type, value_type, true> trie_node_type;
-	typedef trie_node_type * trie_node_ptr;
-	typedef value_list_node<key_type, value_type> node_type;
-	typedef node_type * node_ptr;
-	typedef list_node_base * base_ptr;
-	value_type value;
-	trie_node_ptr node_in_trie;
-
-	explicit value_list_node() : value(), node_in_trie(0)
-	{
-	}
-
-	explicit value_list_node(const value_type& x) : value(x), node_in_trie(0)
-	{
-	}
-
-	~value_list_node() {
-		node_in_trie->self_value_count--;
-	}
-};
-
-typedef boost::intrusive::link_mode<boost::intrusive::safe_link> safe_link_mode;
-typedef boost::intrusive::link_mode<boost::intrusive::normal_link> normal_link_mode;
-typedef boost::intrusive::optimize_size<true> optimized_size;
-typedef boost::intrusive::optimize_size<false> unoptimized_size;
-typedef boost::intrusive::constant_time_size<true> constant_time_size;
-typedef boost::intrusive::constant_time_size<false> not_constant_time_size;
-
-template <typename Key, typename Value, bool isMultiValue>
-struct trie_node;
-
-struct comparator {
-    template <typename Key, typename Value, bool isMultiValue>
-    bool operator () (const trie_node<Key, Value, isMultiValue>& a, const trie_node<Key, Value, isMultiValue>& b) const {
-        return a.key < b.key;
-    }
-
-    template <typename Key, typename Value, bool isMultiValue>
-    bool operator () (const Key& a, const trie_node<Key, Value, isMultiValue>& b) const {
-        return a < b.key;
-    }
-
-    template <typename Key, typename Value, bool isMultiValue>
-    bool operator () (const trie_node<Key, Value, isMultiValue>& a, const Key& b) const {
-        return a.key < b;
-    }
-};
-
-
-template <typename Key, typename Value, bool isMultiValue>
-inline bool operator < (const trie_node<Key, Value, isMultiValue>& a, const trie_node<Key, Value, isMultiValue>& b) {
-    return a.key < b.key;
-}
-
-template <typename Key, typename Value, bool isMultiValue>
-inline bool operator > (const trie_node<Key, Value, isMultiValue>& a, const trie_node<Key, Value, isMultiValue>& b) {
-    return a.key > b.key;
-}
-
-template <typename Key, typename Value, bool isMultiValue>
-inline bool operator == (const trie_node<Key, Value, isMultiValue>& a, const trie_node<Key, Value, isMultiValue>& b) {
-    return a.key == b.key;
-}
-template <typename Key, typename Value>
-struct trie_node<Key, Value, true> : private boost::noncopyable,
-						 public boost::intrusive::set_base_hook<optimized_size, normal_link_mode>
+/*
+ * Node of a trie holding any number of values for its key. The values are
+ * kept in insertion order in a value_vector; iteration goes from the back,
+ * so the newest value comes first.
+ */
+template <typename Key, typename Value, typename ChildPolicy>
+struct trie_node<Key, Value, true, ChildPolicy> : private boost::noncopyable,
+	public ChildPolicy::hook_type
 {
 	typedef Key key_type;
 	typedef Value value_type;
 	typedef value_type * value_ptr;
 	typedef size_t size_type;
-	typedef trie_node<key_type, value_type, true> node_type;
+	typedef trie_node<key_type, value_type, true, ChildPolicy> node_type;
 	typedef node_type* node_ptr;
-	typedef value_list_node<key_type, value_type> value_list_type;
-	typedef value_list_type * value_list_ptr;
-	typedef boost::intrusive::set<node_type, not_constant_time_size> children_type;
-	typedef typename children_type::iterator children_iter;
+	typedef value_vector<value_type> value_vector_type;
+	typedef typename ChildPolicy::template children<key_type, node_type>::type children_type;
 
 	key_type key;
 	children_type children;
 	node_ptr parent;
-	// store the iterator to optimize operator++ and operator--
-	// utilize that the iterator in map does not change after insertion
 	size_type value_count;
-	size_type self_value_count;
-	value_list_ptr value_list_header;
-	value_list_ptr value_list_tail;
+	value_vector_type values;
 
-	explicit trie_node() : parent(0), value_count(0), self_value_count(0),
-	value_list_header(0), value_list_tail(0)
+	explicit trie_node() : parent(0), value_count(0)
 	{
 	}
 
-	explicit trie_node(const key_type& key) : key(key), parent(0), value_count(0), self_value_count(0),
-	value_list_header(0), value_list_tail(0)
+	explicit trie_node(const key_type& key) : key(key), parent(0), value_count(0)
 	{
 	}
 
@@ -136,72 +59,53 @@ struct trie_node<Key, Value, true> : private boost::noncopyable,
 
 	size_type count() const
 	{
-		return self_value_count;
+		return values.size();
 	}
 
 	bool no_value() const
 	{
-		return self_value_count == 0;
+		return values.empty();
+	}
+
+	// index of the newest value, where iteration over the node starts
+	size_type newest_index() const
+	{
+		return values.empty() ? 0 : values.size() - 1;
 	}
 
 	template<typename Allocator>
 	void remove_values(Allocator& alloc) {
-		value_list_ptr vp = value_list_header;
-		if (!no_value())
-		{
-			while (vp != NULL)
-			{
-				value_list_ptr tmp = static_cast<value_list_ptr>(vp->next);
-				alloc.destroy(vp);
-				alloc.deallocate(vp, 1);
-				vp = tmp;
-			}
-		}
-		self_value_count = 0;
-		value_list_header = value_list_tail = NULL;
+		values.clear(alloc);
 	}
 
 	template<typename Allocator>
 	void add_value(const value_type& value, Allocator& alloc) {
-		value_list_ptr vn = alloc.allocate(1);
-		vn = new(vn) value_list_type(value);
-		vn->node_in_trie = this;
-		vn->next = this->value_list_header;
-		if (this->value_list_header != NULL)
-		{
-			this->value_list_header->pred = vn;
-		}
-		else {
-			this->value_list_tail = vn;
-		}
-		this->value_list_header = vn;
-		++this->self_value_count;
+		values.push_back(value, alloc);
+	}
+
+	template<typename Allocator>
+	void erase_value(size_type i, Allocator& alloc) {
+		values.erase(i, alloc);
 	}
 
 	template<typename Allocator>
 	void copy_values_from(const node_type& other, Allocator& alloc) {
-		value_list_ptr vp = other.value_list_header;
-		while (vp != NULL) {
-			this->add_value(vp->value, alloc);
-			vp = static_cast<value_list_ptr>(vp->next);
-		}
-		self_value_count = other.self_value_count;
+		values.assign(other.values, alloc);
 		value_count = other.value_count;
 	}
 };
 
-template <typename Key, typename Value>
-struct trie_node<Key, Value, false> : private boost::noncopyable,
-									  public boost::intrusive::set_base_hook<optimized_size, normal_link_mode>
+template <typename Key, typename Value, typename ChildPolicy>
+struct trie_node<Key, Value, false, ChildPolicy> : private boost::noncopyable,
+	public ChildPolicy::hook_type
 {
 	typedef Key key_type;
 	typedef Value value_type;
 	typedef value_type * value_ptr;
 	typedef size_t size_type;
-	typedef trie_node<key_type, value_type, false> node_type;
+	typedef trie_node<key_type, value_type, false, ChildPolicy> node_type;
 	typedef node_type* node_ptr;
-	typedef boost::intrusive::set<node_type, not_constant_time_size> children_type;
-	typedef typename children_type::iterator children_iter;
+	typedef typename ChildPolicy::template children<key_type, node_type>::type children_type;
 
 	key_type key;
 	value_type value;
@@ -249,18 +153,17 @@ struct trie_node<Key, Value, false> : private boost::noncopyable,
 	}
 };
 
-template <typename Key>
-struct trie_node<Key, void, false> : private boost::noncopyable,
-	public boost::intrusive::set_base_hook<optimized_size, normal_link_mode>
+template <typename Key, typename ChildPolicy>
+struct trie_node<Key, void, false, ChildPolicy> : private boost::noncopyable,
+	public ChildPolicy::hook_type
 {
 	typedef Key key_type;
 	typedef void value_type;
 	typedef value_type * value_ptr;
 	typedef size_t size_type;
-	typedef trie_node<key_type, value_type, false> node_type;
+	typedef trie_node<key_type, value_type, false, ChildPolicy> node_type;
 	typedef node_type* node_ptr;
-	typedef boost::intrusive::set<node_type, not_constant_time_size> children_type;
-	typedef typename children_type::iterator children_iter;
+	typedef typename ChildPolicy::template children<key_type, node_type>::type children_type;
 
 	key_type key;
 	children_type children;
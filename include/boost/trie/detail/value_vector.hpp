@@ -0,0 +1,297 @@
+#ifndef BOOST_TRIE_VALUE_VECTOR_HPP
+#define BOOST_TRIE_VALUE_VECTOR_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <boost/utility.hpp>
+#include <boost/assert.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+#include <boost/type_traits/aligned_storage.hpp>
+#include <boost/blank.hpp>
+#include <boost/trie/detail/trie_children.hpp>
+
+namespace boost { namespace tries {
+
+namespace detail {
+
+/*
+ * The values of a multi value node, in insertion order. The first few
+ * live inside the node, as many as fit in two pointers; more move to a
+ * heap array that grows by doubling and comes back inline when the
+ * values fit again.
+ *
+ * Like the children containers it does not keep an allocator; the
+ * mutating operations take the one of the trie.
+ */
+template <typename T>
+class value_vector : private boost::noncopyable
+{
+public:
+	typedef T value_type;
+	typedef std::size_t size_type;
+
+	enum {
+		inline_capacity = sizeof(T) >= 2 * sizeof(void *) ? 1 : 2 * sizeof(void *) / sizeof(T)
+	};
+
+private:
+	typedef typename boost::aligned_storage<sizeof(T) * inline_capacity,
+		boost::alignment_of<T>::value>::type inline_storage;
+
+	boost::uint32_t count;
+	// 0 while the values are stored inline
+	boost::uint32_t capacity;
+	union {
+		inline_storage small_values;
+		T *heap;
+	} slots;
+
+	T *values()
+	{
+		return capacity == 0 ? reinterpret_cast<T *>(&slots.small_values) : slots.heap;
+	}
+
+	const T *values() const
+	{
+		return capacity == 0 ? reinterpret_cast<const T *>(&slots.small_values) : slots.heap;
+	}
+
+	// destroy the first n values of v, and free v if it is a block
+	template <typename Alloc>
+	static void destroy(T *v, size_type n, size_type block_capacity, Alloc& alloc)
+	{
+		for (size_type i = 0; i < n; ++i)
+			v[i].~T();
+		if (block_capacity != 0)
+			deallocate_block(alloc, v, block_capacity);
+	}
+
+	/*
+	 * Move the values to a block of new_capacity, 0 meaning inline. All
+	 * values are copied before any old one goes, so if a copy throws the
+	 * vector is left as it was.
+	 */
+	template <typename Alloc>
+	void reallocate(size_type new_capacity, Alloc& alloc)
+	{
+		BOOST_ASSERT(count <= (new_capacity == 0 ? size_type(inline_capacity) : new_capacity));
+		// the inline storage overlaps the heap pointer, old keeps it
+		T *old = values();
+		T *dest = new_capacity == 0 ? reinterpret_cast<T *>(&slots.small_values)
+			: allocate_block<T>(alloc, new_capacity);
+		size_type built = 0;
+		try {
+			for (; built < count; ++built)
+				new(dest + built) T(old[built]);
+		} catch (...) {
+			destroy(dest, built, new_capacity, alloc);
+			if (new_capacity == 0)
+				slots.heap = old;
+			throw;
+		}
+		destroy(old, count, capacity, alloc);
+		if (new_capacity != 0)
+			slots.heap = dest;
+		capacity = static_cast<boost::uint32_t>(new_capacity);
+	}
+
+	// shrinking only saves memory, so a value that fails to copy keeps
+	// the values where they are instead of failing the erase
+	template <typename Alloc>
+	void shrink(size_type new_capacity, Alloc& alloc)
+	{
+		try {
+			reallocate(new_capacity, alloc);
+		} catch (...) {
+		}
+	}
+
+public:
+	explicit value_vector() : count(0), capacity(0)
+	{
+	}
+
+	~value_vector()
+	{
+		BOOST_ASSERT(count == 0 && capacity == 0);
+	}
+
+	size_type size() const
+	{
+		return count;
+	}
+
+	// the count and capacity are 32 bits to keep the node small
+	static size_type max_size()
+	{
+		return boost::uint32_t(-1);
+	}
+
+	bool empty() const
+	{
+		return count == 0;
+	}
+
+	T& operator[](size_type i)
+	{
+		BOOST_ASSERT(i < count);
+		return values()[i];
+	}
+
+	const T& operator[](size_type i) const
+	{
+		BOOST_ASSERT(i < count);
+		return values()[i];
+	}
+
+	template <typename Alloc>
+	void push_back(const T& value, Alloc& alloc)
+	{
+		size_type limit = capacity == 0 ? size_type(inline_capacity) : capacity;
+		if (count == limit)
+		{
+			size_type new_capacity = size_type(limit) * 2;
+			if (new_capacity > max_size())
+				throw std::length_error("value_vector: too many values in a node");
+			reallocate(new_capacity, alloc);
+		}
+		new(values() + count) T(value);
+		++count;
+	}
+
+	// later values move down by one
+	template <typename Alloc>
+	void erase(size_type i, Alloc& alloc)
+	{
+		BOOST_ASSERT(i < count);
+		T *v = values();
+		for (size_type j = i + 1; j < count; ++j)
+			v[j - 1] = v[j];
+		--count;
+		v[count].~T();
+		if (capacity != 0 && count <= inline_capacity)
+			shrink(0, alloc);
+		else if (capacity > inline_capacity * 2 && count <= capacity / 4)
+			shrink(capacity / 2, alloc);
+	}
+
+	template <typename Alloc>
+	void clear(Alloc& alloc)
+	{
+		destroy(values(), count, capacity, alloc);
+		count = 0;
+		capacity = 0;
+	}
+
+	template <typename Alloc>
+	void assign(const value_vector& other, Alloc& alloc)
+	{
+		clear(alloc);
+		if (other.count > inline_capacity)
+		{
+			slots.heap = allocate_block<T>(alloc, other.count);
+			capacity = other.count;
+		}
+		T *v = values();
+		size_type built = 0;
+		try {
+			for (; built < other.count; ++built)
+				new(v + built) T(other[built]);
+		} catch (...) {
+			destroy(v, built, capacity, alloc);
+			capacity = 0;
+			throw;
+		}
+		count = other.count;
+	}
+};
+
+/*
+ * boost::blank values, the multiset case, carry nothing: only their number
+ * is kept, so adding or removing a duplicate is a counter update
+ */
+template <>
+class value_vector<boost::blank> : private boost::noncopyable
+{
+public:
+	typedef boost::blank value_type;
+	typedef std::size_t size_type;
+
+private:
+	size_type count;
+
+	static boost::blank& blank_value()
+	{
+		static boost::blank value;
+		return value;
+	}
+
+public:
+	explicit value_vector() : count(0)
+	{
+	}
+
+	~value_vector()
+	{
+		BOOST_ASSERT(count == 0);
+	}
+
+	size_type size() const
+	{
+		return count;
+	}
+
+	bool empty() const
+	{
+		return count == 0;
+	}
+
+	boost::blank& operator[](size_type i)
+	{
+		BOOST_ASSERT(i < count);
+		return blank_value();
+	}
+
+	const boost::blank& operator[](size_type i) const
+	{
+		BOOST_ASSERT(i < count);
+		return blank_value();
+	}
+
+	template <typename Alloc>
+	void push_back(const boost::blank&, Alloc&)
+	{
+		++count;
+	}
+
+	template <typename Alloc>
+	void erase(size_type i, Alloc&)
+	{
+		BOOST_ASSERT(i < count);
+		--count;
+	}
+
+	template <typename Alloc>
+	void clear(Alloc&)
+	{
+		count = 0;
+	}
+
+	template <typename Alloc>
+	void assign(const value_vector& other, Alloc&)
+	{
+		count = other.count;
+	}
+};
+
+} /* detail */
+} /* tries */
+} /* boost */
+
+#endif
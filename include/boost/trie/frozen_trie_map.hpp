@@ -0,0 +1,226 @@
+#ifndef BOOST_FROZEN_TRIE_MAP
+#define BOOST_FROZEN_TRIE_MAP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <boost/trie/trie_map.hpp>
+#include <boost/trie/detail/double_array.hpp>
+#include <boost/trie/detail/frozen_iterator.hpp>
+
+namespace boost { namespace tries {
+
+/*
+ * Read only copy of a trie_map with byte keys, stored as a double-array.
+ * Values are kept in key order next to the array.
+ */
+template<typename Key, typename Value>
+class frozen_trie_map
+{
+public:
+	typedef Key key_type;
+	typedef Value value_type;
+	typedef detail::double_array<key_type> double_array_type;
+	typedef frozen_trie_map<Key, Value> frozen_trie_map_type;
+	typedef detail::frozen_iterator<key_type, value_type> const_iterator;
+	typedef const_iterator iterator;
+	typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+	typedef const_reverse_iterator reverse_iterator;
+	typedef std::pair<iterator, iterator> iterator_range;
+	typedef size_t size_type;
+
+protected:
+	double_array_type da;
+	std::vector<value_type> values;
+
+	iterator at_rank(size_type rank) const
+	{
+		return iterator(&da, values.empty() ? NULL : &values[0], rank);
+	}
+
+public:
+	explicit frozen_trie_map() : da(), values()
+	{
+	}
+
+	template<typename ChildPolicy, typename Allocator>
+	explicit frozen_trie_map(const trie_map<Key, Value, ChildPolicy, Allocator>& other) : da(), values()
+	{
+		freeze(other);
+	}
+
+	// rebuild from a trie_map, replacing the current contents
+	template<typename ChildPolicy, typename Allocator>
+	void freeze(const trie_map<Key, Value, ChildPolicy, Allocator>& other)
+	{
+		typedef typename trie_map<Key, Value, ChildPolicy, Allocator>::const_iterator source_iterator;
+		std::vector<std::vector<unsigned char> > keys;
+		std::vector<value_type> new_values;
+		keys.reserve(other.size());
+		new_values.reserve(other.size());
+		for (source_iterator it = other.begin(); it != other.end(); ++it)
+		{
+			std::vector<key_type> key = it.get_key();
+			keys.push_back(std::vector<unsigned char>(key.size()));
+			for (size_type i = 0; i < key.size(); ++i)
+				keys.back()[i] = detail::byte_key_index(key[i]);
+			new_values.push_back((*it).second);
+		}
+		da.build(keys);
+		values.swap(new_values);
+	}
+
+	const_iterator begin() const
+	{
+		return at_rank(0);
+	}
+
+	const_iterator cbegin() const
+	{
+		return begin();
+	}
+
+	const_iterator end() const
+	{
+		return at_rank(da.size());
+	}
+
+	const_iterator cend() const
+	{
+		return end();
+	}
+
+	const_reverse_iterator rbegin() const
+	{
+		return const_reverse_iterator(end());
+	}
+
+	const_reverse_iterator crbegin() const
+	{
+		return rbegin();
+	}
+
+	const_reverse_iterator rend() const
+	{
+		return const_reverse_iterator(begin());
+	}
+
+	const_reverse_iterator crend() const
+	{
+		return rend();
+	}
+
+	// find
+	template<typename Iter>
+	const_iterator find(Iter first, Iter last) const
+	{
+		typename double_array_type::state_type s = da.find_state(first, last);
+		if (s < 0 || !da.is_terminal(s))
+			return end();
+		return at_rank(da.first_rank(s));
+	}
+
+	template<typename Container>
+	const_iterator find(const Container& container) const
+	{
+		return find(container.begin(), container.end());
+	}
+
+	// count
+	template<typename Iter>
+	size_type count(Iter first, Iter last) const
+	{
+		typename double_array_type::state_type s = da.find_state(first, last);
+		return s >= 0 && da.is_terminal(s);
+	}
+
+	template<typename Container>
+	size_type count(const Container& container) const
+	{
+		return count(container.begin(), container.end());
+	}
+
+	template<typename Iter>
+	size_type count_prefix(Iter first, Iter last) const
+	{
+		typename double_array_type::state_type s = da.find_state(first, last);
+		return s < 0 ? 0 : da.prefix_count(s);
+	}
+
+	template<typename Container>
+	size_type count_prefix(const Container& container) const
+	{
+		return count_prefix(container.begin(), container.end());
+	}
+
+	// find_with_prefix
+	template<typename Iter>
+	iterator_range find_prefix(Iter first, Iter last) const
+	{
+		typename double_array_type::state_type s = da.find_state(first, last);
+		if (s < 0)
+			return std::make_pair(end(), end());
+		size_type rank = da.first_rank(s);
+		return std::make_pair(at_rank(rank), at_rank(rank + da.prefix_count(s)));
+	}
+
+	template<typename Container>
+	iterator_range find_prefix(const Container& container) const
+	{
+		return find_prefix(container.begin(), container.end());
+	}
+
+	// upper and lower bound
+	template<typename Iter>
+	const_iterator lower_bound(Iter first, Iter last) const
+	{
+		bool exact;
+		return at_rank(da.lower_bound_rank(first, last, exact));
+	}
+
+	template<typename Container>
+	const_iterator lower_bound(const Container& container) const
+	{
+		return lower_bound(container.begin(), container.end());
+	}
+
+	template<typename Iter>
+	const_iterator upper_bound(Iter first, Iter last) const
+	{
+		bool exact;
+		size_type rank = da.lower_bound_rank(first, last, exact);
+		return at_rank(exact ? rank + 1 : rank);
+	}
+
+	template<typename Container>
+	const_iterator upper_bound(const Container& container) const
+	{
+		return upper_bound(container.begin(), container.end());
+	}
+
+	size_type count_node() const
+	{
+		return da.count_node();
+	}
+
+	size_type size() const
+	{
+		return da.size();
+	}
+
+	bool empty() const
+	{
+		return da.size() == 0;
+	}
+
+	void clear()
+	{
+		da.clear();
+		values.clear();
+	}
+};
+
+}	// namespace tries
+}	// namespace boost
+#endif
@@ -0,0 +1,264 @@
+#ifndef BOOST_LOUDS_TRIE_SET
+#define BOOST_LOUDS_TRIE_SET
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <vector>
+#include <queue>
+#include <algorithm>
+#include <boost/trie/trie_set.hpp>
+#include <boost/trie/detail/succinct_bitvector.hpp>
+
+namespace boost { namespace tries {
+
+/*
+ * Immutable set of keys stored as a LOUDS (level-order unary degree
+ * sequence) trie. Nodes are numbered in breadth first order; a node of
+ * degree d is written as d ones and a zero, after a leading "10" for a
+ * super root. With rank and select over those bits a node costs about
+ * two bits, plus one terminal bit and its label.
+ *
+ * The children of a node have consecutive numbers, and so have all the
+ * descendants of a node on any one level, which is what count_prefix
+ * relies on.
+ */
+template<typename Key>
+class louds_trie_set
+{
+public:
+	typedef Key key_type;
+	typedef louds_trie_set<Key> louds_trie_set_type;
+	typedef size_t size_type;
+	typedef size_t node_id;
+
+	static const node_id npos = static_cast<node_id>(-1);
+
+private:
+	detail::succinct_bitvector louds;
+	detail::succinct_bitvector terminal;
+	// label of the edge into node i is labels[i - 1]
+	std::vector<key_type> labels;
+	size_type node_count;
+	size_type key_count;
+
+	struct build_frame {
+		size_type lo, hi, depth;
+	};
+
+	static bool key_equal(const key_type& a, const key_type& b)
+	{
+		return !(a < b) && !(b < a);
+	}
+
+	// number of the first child of node, children follow consecutively
+	node_id first_child(node_id node) const
+	{
+		return louds.select0(node) - node;
+	}
+
+	node_id child_end(node_id node) const
+	{
+		return louds.select0(node + 1) - (node + 1);
+	}
+
+	node_id child(node_id node, const key_type& key) const
+	{
+		node_id first = first_child(node), last = child_end(node);
+		typename std::vector<key_type>::const_iterator it =
+			std::lower_bound(labels.begin() + (first - 1), labels.begin() + (last - 1), key);
+		if (it == labels.begin() + (last - 1) || key < *it)
+			return npos;
+		return static_cast<node_id>(it - labels.begin()) + 1;
+	}
+
+	void build(const std::vector<std::vector<key_type> >& keys)
+	{
+		louds.clear();
+		terminal.clear();
+		labels.clear();
+		node_count = 0;
+		key_count = keys.size();
+
+		louds.push_back(true);
+		louds.push_back(false);
+		std::queue<build_frame> que;
+		build_frame root = { 0, keys.size(), 0 };
+		que.push(root);
+		while (!que.empty())
+		{
+			build_frame f = que.front();
+			que.pop();
+			size_type lo = f.lo;
+			bool ends_here = lo < f.hi && keys[lo].size() == f.depth;
+			terminal.push_back(ends_here);
+			if (ends_here)
+				++lo;
+			while (lo < f.hi)
+			{
+				size_type hi = lo + 1;
+				while (hi < f.hi && key_equal(keys[hi][f.depth], keys[lo][f.depth]))
+					++hi;
+				louds.push_back(true);
+				labels.push_back(keys[lo][f.depth]);
+				build_frame cf = { lo, hi, f.depth + 1 };
+				que.push(cf);
+				lo = hi;
+			}
+			louds.push_back(false);
+		}
+		node_count = labels.size();
+		louds.build();
+		terminal.build();
+		std::vector<key_type>(labels).swap(labels);
+	}
+
+	template<typename OutIter>
+	OutIter collect(node_id node, std::vector<key_type>& key_path, OutIter out) const
+	{
+		if (terminal[node])
+			*out++ = key_path;
+		node_id last = child_end(node);
+		for (node_id c = first_child(node); c < last; ++c)
+		{
+			key_path.push_back(labels[c - 1]);
+			out = collect(c, key_path, out);
+			key_path.pop_back();
+		}
+		return out;
+	}
+
+public:
+	explicit louds_trie_set() : node_count(0), key_count(0)
+	{
+		build(std::vector<std::vector<key_type> >());
+	}
+
+	template<typename ChildPolicy, typename Allocator>
+	explicit louds_trie_set(const trie_set<Key, ChildPolicy, Allocator>& other) : node_count(0), key_count(0)
+	{
+		typedef typename trie_set<Key, ChildPolicy, Allocator>::const_iterator source_iterator;
+		std::vector<std::vector<key_type> > keys;
+		keys.reserve(other.size());
+		for (source_iterator it = other.begin(); it != other.end(); ++it)
+			keys.push_back(*it);
+		build(keys);
+	}
+
+	// from a range of key containers sorted by operator<, duplicates are merged
+	template<typename Iter>
+	explicit louds_trie_set(Iter first, Iter last) : node_count(0), key_count(0)
+	{
+		std::vector<std::vector<key_type> > keys;
+		for (; first != last; ++first)
+		{
+			std::vector<key_type> key(first->begin(), first->end());
+			if (keys.empty() || keys.back() < key)
+				keys.push_back(key);
+			else
+				BOOST_ASSERT(!(key < keys.back()));
+		}
+		build(keys);
+	}
+
+	// the node reached by [first, last), npos if there is none
+	template<typename Iter>
+	node_id find_node(Iter first, Iter last) const
+	{
+		node_id node = 0;
+		for (; first != last && node != npos; ++first)
+			node = child(node, *first);
+		return node;
+	}
+
+	template<typename Container>
+	node_id find_node(const Container& container) const
+	{
+		return find_node(container.begin(), container.end());
+	}
+
+	template<typename Iter>
+	size_type count(Iter first, Iter last) const
+	{
+		node_id node = find_node(first, last);
+		return node != npos && terminal[node];
+	}
+
+	template<typename Container>
+	size_type count(const Container& container) const
+	{
+		return count(container.begin(), container.end());
+	}
+
+	// keys below the node, summed level by level over its descendant range
+	template<typename Iter>
+	size_type count_prefix(Iter first, Iter last) const
+	{
+		node_id l = find_node(first, last);
+		if (l == npos)
+			return 0;
+		node_id r = l + 1;
+		size_type ret = 0;
+		while (l < r)
+		{
+			ret += terminal.rank1(r) - terminal.rank1(l);
+			l = first_child(l);
+			r = first_child(r);
+		}
+		return ret;
+	}
+
+	template<typename Container>
+	size_type count_prefix(const Container& container) const
+	{
+		return count_prefix(container.begin(), container.end());
+	}
+
+	// write every key with the prefix to out, in order, as std::vector<Key>
+	template<typename Iter, typename OutIter>
+	OutIter find_prefix(Iter first, Iter last, OutIter out) const
+	{
+		std::vector<key_type> key_path(first, last);
+		node_id node = find_node(key_path.begin(), key_path.end());
+		if (node == npos)
+			return out;
+		return collect(node, key_path, out);
+	}
+
+	template<typename Container, typename OutIter>
+	OutIter find_prefix(const Container& container, OutIter out) const
+	{
+		return find_prefix(container.begin(), container.end(), out);
+	}
+
+	// nodes other than the root
+	size_type count_node() const
+	{
+		return node_count;
+	}
+
+	size_type size() const
+	{
+		return key_count;
+	}
+
+	bool empty() const
+	{
+		return key_count == 0;
+	}
+
+	// bytes used by the bit vectors and the labels
+	size_type memory_size() const
+	{
+		return louds.memory_size() + terminal.memory_size()
+			+ labels.size() * sizeof(key_type);
+	}
+};
+
+template<typename Key>
+const typename louds_trie_set<Key>::node_id louds_trie_set<Key>::npos;
+
+}	// namespace tries
+}	// namespace boost
+#endif
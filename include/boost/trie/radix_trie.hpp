@@ -0,0 +1,579 @@
+#ifndef BOOST_RADIX_TRIE_HPP
+#define BOOST_RADIX_TRIE_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <stack>
+#include <boost/trie/detail/radix_node.hpp>
+#include <boost/trie/detail/radix_iterator.hpp>
+#include <boost/type_traits/is_void.hpp>
+#include <boost/mpl/if.hpp>
+#include <boost/blank.hpp>
+
+namespace boost { namespace tries {
+
+/*
+ * Path compressed (radix / patricia) trie with unique keys. A chain of
+ * valueless single child nodes is kept as one node whose edge carries
+ * the whole label, edges are split on insert and merged back on erase.
+ */
+template <typename Key, typename Value, typename ChildPolicy = adaptive_children_policy>
+class radix_trie {
+public:
+	typedef Key key_type;
+	typedef typename boost::mpl::if_
+	<
+		boost::is_void<Value>,
+		boost::blank,
+		Value
+	>::type non_void_value_type;
+	typedef Value value_type;
+	typedef ChildPolicy child_policy;
+	typedef radix_trie<key_type, Value, child_policy> radix_trie_type;
+	typedef typename detail::radix_node<key_type, value_type, child_policy> node_type;
+	typedef node_type * node_ptr;
+	typedef size_t size_type;
+	typedef std::allocator<node_type> node_alloc_type;
+
+private:
+	node_alloc_type node_allocator;
+
+	node_type root;
+	size_type node_count;
+
+	node_ptr create_radix_node(const key_type& key)
+	{
+		node_ptr new_node = node_allocator.allocate(1);
+		return new(new_node) node_type(key);
+	}
+
+	void destroy_radix_node(node_ptr node)
+	{
+		node->tail.release(node_allocator);
+		node->~node_type();
+		node_allocator.deallocate(node, 1);
+	}
+
+	node_ptr leftmost_node(node_ptr node) const
+	{
+		node_ptr cur = node;
+		while (!cur->children.empty() && cur->no_value())
+		{
+			cur = cur->children.front();
+		}
+		return cur;
+	}
+
+	// first node with a value after the whole sub-trie of node
+	node_ptr next_subtree(node_ptr node) const
+	{
+		while (node->parent != NULL)
+		{
+			node_ptr sibling = node->parent->children.next(node);
+			if (sibling != NULL)
+				return leftmost_node(sibling);
+			node = node->parent;
+		}
+		return node;
+	}
+
+	// split the edge of child after pos elements of its tail,
+	// the new upper node takes the first part of the label
+	node_ptr split_node(node_ptr child, size_type pos)
+	{
+		node_ptr parent = child->parent;
+		node_ptr upper = create_radix_node(child->key);
+		node_count++;
+		upper->tail.assign(child->tail.begin(), child->tail.begin() + pos, node_allocator);
+		upper->parent = parent;
+		upper->value_count = child->value_count;
+		parent->children.erase(child, node_allocator);
+		child->key = child->tail[pos];
+		child->tail.erase_front(pos + 1);
+		child->parent = upper;
+		upper->children.insert(child, node_allocator);
+		parent->children.insert(upper, node_allocator);
+		return upper;
+	}
+
+	// fold a valueless node into its only child; the label grows first,
+	// so a key that fails to copy leaves the nodes linked as they were
+	void merge_with_child(node_ptr node)
+	{
+		node_ptr child = node->children.front();
+		node_ptr parent = node->parent;
+		child->tail.prepend(node->tail, child->key, node_allocator);
+		node->children.erase(child, node_allocator);
+		parent->children.erase(node, node_allocator);
+		child->key = node->key;
+		child->parent = parent;
+		parent->children.insert(child, node_allocator);
+		destroy_radix_node(node);
+		node_count--;
+	}
+
+	// the node where the matching of [first, last) ends; if the key ends
+	// inside an edge, the node below that edge is returned and exact is false
+	template<typename Iter>
+		node_ptr locate(Iter first, Iter last, bool& exact) const
+		{
+			node_ptr cur = const_cast<node_ptr>(&root);
+			exact = true;
+			while (first != last)
+			{
+				node_ptr child = cur->children.find(*first);
+				if (child == NULL)
+					return NULL;
+				++first;
+				typename node_type::label_type::const_iterator ti = child->tail.begin();
+				for (; ti != child->tail.end() && first != last; ++ti, ++first)
+				{
+					if (!detail::key_equal(*ti, *first))
+						return NULL;
+				}
+				cur = child;
+				if (ti != child->tail.end())
+					exact = false;
+			}
+			return cur;
+		}
+
+	// copy the whole trie tree
+	void copy_tree(node_ptr other_root)
+	{
+		if (other_root == &root)
+			return;
+
+		clear();
+
+		std::stack<node_ptr> other_node_stk, self_node_stk;
+		std::stack<node_ptr> ci_stk;
+		other_node_stk.push(other_root);
+		self_node_stk.push(&root);
+		ci_stk.push(other_root->children.front());
+		for (; !other_node_stk.empty(); )
+		{
+			node_ptr other_cur = other_node_stk.top();
+			node_ptr self_cur = self_node_stk.top();
+			if (ci_stk.top() == NULL)
+			{
+				other_node_stk.pop();
+				ci_stk.pop();
+				self_node_stk.pop();
+			} else {
+				node_ptr c = ci_stk.top();
+				node_ptr new_node = create_radix_node(c->key);
+				node_count++;
+				new_node->tail.assign(c->tail.begin(), c->tail.end(), node_allocator);
+				new_node->value = c->value;
+				new_node->has_value = c->has_value;
+				new_node->value_count = c->value_count;
+				new_node->parent = self_cur;
+				self_cur->children.insert(new_node, node_allocator);
+				ci_stk.top() = other_cur->children.next(c);
+				other_node_stk.push(c);
+				ci_stk.push(c->children.front());
+				self_node_stk.push(new_node);
+			}
+		}
+		root.value = other_root->value;
+		root.has_value = other_root->has_value;
+		root.value_count = other_root->value_count;
+	}
+
+public:
+	explicit radix_trie() : node_allocator(), node_count(0)
+	{
+	}
+
+	explicit radix_trie(const radix_trie_type& t) : node_allocator(), node_count(0)
+	{
+		copy_tree(const_cast<node_ptr>(&t.root));
+	}
+
+	radix_trie_type& operator=(const radix_trie_type& t)
+	{
+		copy_tree(const_cast<node_ptr>(&t.root));
+		return *this;
+	}
+
+	typedef detail::radix_iterator<Key, Value, child_policy> iterator;
+	typedef typename iterator::const_iterator const_iterator;
+	typedef std::reverse_iterator<iterator> reverse_iterator;
+	typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+	typedef std::pair<iterator, bool> pair_iterator_bool;
+	typedef std::pair<iterator, iterator> iterator_range;
+
+	iterator begin()
+	{
+		return leftmost_node(&root);
+	}
+
+	const_iterator begin() const
+	{
+		return leftmost_node(const_cast<node_ptr>(&root));
+	}
+
+	const_iterator cbegin() const
+	{
+		return leftmost_node(const_cast<node_ptr>(&root));
+	}
+
+	iterator end()
+	{
+		return (&root);
+	}
+
+	const_iterator end() const
+	{
+		return const_cast<node_ptr>(&root);
+	}
+
+	const_iterator cend() const
+	{
+		return const_cast<node_ptr>(&root);
+	}
+
+	reverse_iterator rbegin()
+	{
+		return static_cast<reverse_iterator>(end());
+	}
+
+	const_reverse_iterator rbegin() const
+	{
+		return static_cast<const_reverse_iterator>(cend());
+	}
+
+	const_reverse_iterator crbegin() const
+	{
+		return rbegin();
+	}
+
+	reverse_iterator rend()
+	{
+		return static_cast<reverse_iterator>(begin());
+	}
+
+	const_reverse_iterator rend() const
+	{
+		return static_cast<const_reverse_iterator>(cbegin());
+	}
+
+	const_reverse_iterator crend() const
+	{
+		return rend();
+	}
+
+	template<typename Iter>
+		pair_iterator_bool insert_unique(Iter first, Iter last,
+				const non_void_value_type& value = non_void_value_type())
+		{
+			node_ptr cur = &root;
+			while (first != last)
+			{
+				node_ptr child = cur->children.find(*first);
+				if (child == NULL)
+				{
+					// the rest of the key becomes the label of a new leaf
+					node_ptr new_node = create_radix_node(*first);
+					node_count++;
+					new_node->tail.assign(++first, last, node_allocator);
+					new_node->parent = cur;
+					cur->children.insert(new_node, node_allocator);
+					cur = new_node;
+					break;
+				}
+				++first;
+				size_type matched = 0;
+				while (matched < child->tail.size() && first != last
+						&& detail::key_equal(child->tail[matched], *first))
+				{
+					++matched;
+					++first;
+				}
+				if (matched < child->tail.size())
+				{
+					// the key ends or diverges inside the edge
+					cur = split_node(child, matched);
+					continue;
+				}
+				cur = child;
+			}
+
+			if (!cur->no_value())
+				return std::make_pair(iterator(cur), false);
+
+			cur->value = value;
+			cur->has_value = true;
+			// update value_count on the path
+			for (node_ptr tmp = cur; tmp != NULL; tmp = tmp->parent)
+				++tmp->value_count;
+			return std::make_pair(iterator(cur), true);
+		}
+
+	template<typename Container>
+		pair_iterator_bool insert_unique(const Container &container,
+				const non_void_value_type& value = non_void_value_type())
+		{
+			return insert_unique(container.begin(), container.end(), value);
+		}
+
+	template<typename Iter>
+		node_ptr find_node(Iter first, Iter last)
+		{
+			bool exact;
+			node_ptr node = locate(first, last, exact);
+			return exact ? node : NULL;
+		}
+
+	template<typename Container>
+		node_ptr find_node(const Container &container)
+		{
+			return find_node(container.begin(), container.end());
+		}
+
+	template<typename Iter>
+		iterator find(Iter first, Iter last)
+		{
+			node_ptr node = find_node(first, last);
+			if (node == NULL || node->no_value())
+				return end();
+			return node;
+		}
+
+	template<typename Container>
+		iterator find(const Container &container)
+		{
+			return find(container.begin(), container.end());
+		}
+
+	template<typename Iter>
+		size_type count(Iter first, Iter last)
+		{
+			node_ptr node = find_node(first, last);
+			if (node == NULL)
+				return 0;
+			return node->count();
+		}
+
+	template<typename Container>
+		size_type count(const Container &container)
+		{
+			return count(container.begin(), container.end());
+		}
+
+	// find by prefix, return a pair of iterator(begin, end)
+	template<typename Iter>
+		iterator_range find_prefix(Iter first, Iter last)
+		{
+			bool exact;
+			node_ptr node = locate(first, last, exact);
+			if (node == NULL)
+				return std::make_pair(end(), end());
+			return std::make_pair(iterator(leftmost_node(node)), iterator(next_subtree(node)));
+		}
+
+	template<typename Container>
+		iterator_range find_prefix(const Container &container)
+		{
+			return find_prefix(container.begin(), container.end());
+		}
+
+	template<typename Iter>
+		size_type count_prefix(Iter first, Iter last)
+		{
+			bool exact;
+			node_ptr node = locate(first, last, exact);
+			if (node == NULL)
+				return 0;
+			return node->value_count;
+		}
+
+	template<typename Container>
+		size_type count_prefix(const Container &container)
+		{
+			return count_prefix(container.begin(), container.end());
+		}
+
+	// lower_bound(), second is true on a full match
+	template<typename Iter>
+		std::pair<iterator, bool> lower_bound(Iter first, Iter last)
+		{
+			node_ptr cur = &root;
+			while (first != last)
+			{
+				node_ptr child = cur->children.find(*first);
+				if (child == NULL)
+				{
+					node_ptr lb_candidate = cur->children.upper_bound(*first);
+					if (lb_candidate == NULL)
+						return std::make_pair(iterator(next_subtree(cur)), false);
+					return std::make_pair(iterator(leftmost_node(lb_candidate)), false);
+				}
+				++first;
+				typename node_type::label_type::const_iterator ti = child->tail.begin();
+				for (; ti != child->tail.end(); ++ti, ++first)
+				{
+					// the key is a proper prefix of the edge or sorts before it
+					if (first == last || *first < *ti)
+						return std::make_pair(iterator(leftmost_node(child)), false);
+					if (*ti < *first)
+						return std::make_pair(iterator(next_subtree(child)), false);
+				}
+				cur = child;
+			}
+
+			if (!cur->no_value())
+				return std::make_pair(iterator(cur), true);
+			return std::make_pair(iterator(leftmost_node(cur)), false);
+		}
+
+	template<typename Container>
+		iterator lower_bound(const Container &container)
+		{
+			return lower_bound(container.begin(), container.end()).first;
+		}
+
+	template<typename Iter>
+		iterator upper_bound(Iter first, Iter last)
+		{
+			std::pair<iterator, bool> lb_result = lower_bound(first, last);
+			if (lb_result.second)
+				++lb_result.first;
+			return lb_result.first;
+		}
+
+	template<typename Container>
+		iterator upper_bound(const Container &container)
+		{
+			return upper_bound(container.begin(), container.end());
+		}
+
+	// delete empty ancestors, update value_count and merge the
+	// remaining node with its child if it is left with only one
+	void erase_check_ancestor(node_ptr cur, size_type delta)
+	{
+		while (cur != &root && cur->children.empty() && cur->no_value())
+		{
+			node_ptr parent = cur->parent;
+			parent->children.erase(cur, node_allocator);
+			destroy_radix_node(cur);
+			node_count--;
+			cur = parent;
+		}
+
+		for (node_ptr tmp = cur; tmp != NULL; tmp = tmp->parent)
+			tmp->value_count -= delta;
+
+		if (cur != &root && cur->no_value() && cur->children.size() == 1)
+			merge_with_child(cur);
+	}
+
+	size_type erase_node(node_ptr node)
+	{
+		if (node == NULL || node->no_value())
+			return 0;
+		node->has_value = false;
+		node->value = non_void_value_type();
+		erase_check_ancestor(node, 1);
+		return 1;
+	}
+
+	// nodes holding a value are never freed by erasing another key,
+	// so the successor can be taken before erasing
+	iterator erase(iterator it)
+	{
+		if (it == end())
+			return it;
+		iterator ret = it;
+		++ret;
+		erase_node(it.tnode);
+		return ret;
+	}
+
+	iterator erase(const_iterator it)
+	{
+		return erase(iterator(it.tnode));
+	}
+
+	template<typename Iter>
+		iterator erase(Iter first, Iter last)
+		{
+			return erase(find(first, last));
+		}
+
+	template<typename Container>
+		iterator erase(const Container &container)
+		{
+			return erase(container.begin(), container.end());
+		}
+
+	// erase all keys with prefix
+	template<typename Iter>
+		size_type erase_prefix(Iter first, Iter last)
+		{
+			bool exact;
+			node_ptr cur = locate(first, last, exact);
+			if (cur == NULL)
+				return 0;
+			size_type ret = cur->value_count;
+			clear(cur);
+			return ret;
+		}
+
+	template<typename Container>
+		size_type erase_prefix(const Container &container)
+		{
+			return erase_prefix(container.begin(), container.end());
+		}
+
+	// erase the whole sub-trie rooted at node, node itself included
+	void clear(node_ptr node)
+	{
+		size_type delta = node->value_count;
+		node_ptr cur = node;
+		while (true)
+		{
+			while (!cur->children.empty())
+				cur = cur->children.back();
+			if (cur == node)
+				break;
+			node_ptr parent = cur->parent;
+			parent->children.erase(cur, node_allocator);
+			destroy_radix_node(cur);
+			node_count--;
+			cur = parent;
+		}
+		node->has_value = false;
+		node->value = non_void_value_type();
+		erase_check_ancestor(node, delta);
+	}
+
+	void clear()
+	{
+		clear(&root);
+	}
+
+	size_type count_node() const {
+		return node_count;
+	}
+
+	size_type size() const {
+		return root.value_count;
+	}
+
+	bool empty() const {
+		return root.value_count == 0;
+	}
+
+	~radix_trie()
+	{
+		clear();
+	}
+};
+
+} // tries
+} // boost
+#endif // BOOST_RADIX_TRIE_HPP
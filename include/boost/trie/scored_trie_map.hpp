@@ -0,0 +1,369 @@
+#ifndef BOOST_SCORED_TRIE_MAP
+#define BOOST_SCORED_TRIE_MAP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <queue>
+#include <vector>
+#include <boost/trie/trie.hpp>
+
+namespace boost { namespace tries {
+
+/*
+ * What a scored_trie_map keeps in each node: the score of its key and
+ * the highest score in its subtree. Nodes without a key of their own
+ * only have the second.
+ */
+template<typename Score>
+struct scored_entry
+{
+	Score score;
+	Score subtree_max;
+
+	explicit scored_entry() : score(), subtree_max()
+	{
+	}
+
+	explicit scored_entry(const Score& s) : score(s), subtree_max(s)
+	{
+	}
+};
+
+/*
+ * Map from keys to scores answering top_k(prefix, k), the k keys with
+ * the highest scores under a prefix, by a best-first search over the
+ * subtree maxima: a subtree is opened only when its maximum can still
+ * make the result, so about k * depth nodes are opened instead of the
+ * whole prefix range.
+ *
+ * The maxima are kept up to date along the path of each change, the
+ * way value_count is. Score needs operator<; the iterators are constant
+ * since changing a score in place would leave the maxima stale, use
+ * set_score() instead.
+ */
+template<typename Key, typename Score, typename ChildPolicy = adaptive_children_policy,
+	typename Allocator = std::allocator<Score> >
+class scored_trie_map
+{
+public:
+	typedef Key key_type;
+	typedef Score score_type;
+	typedef scored_entry<Score> value_type;
+	typedef ChildPolicy child_policy;
+	typedef Allocator allocator_type;
+	typedef trie<key_type, value_type, false, child_policy, allocator_type> trie_type;
+	typedef scored_trie_map<Key, Score, child_policy, allocator_type> scored_trie_map_type;
+	typedef typename trie_type::const_iterator iterator;
+	typedef typename trie_type::const_iterator const_iterator;
+	typedef typename trie_type::const_reverse_iterator reverse_iterator;
+	typedef typename trie_type::const_reverse_iterator const_reverse_iterator;
+	typedef std::pair<const_iterator, bool> pair_iterator_bool;
+	typedef typename trie_type::iterator_range iterator_range;
+	typedef size_t size_type;
+
+private:
+	typedef typename trie_type::node_ptr node_ptr;
+
+	trie_type t;
+
+	// a node, or the score of the key at a node, queued by the best score it can lead to
+	struct search_entry {
+		score_type bound;
+		node_ptr node;
+		bool is_key;
+
+		bool operator<(const search_entry& other) const
+		{
+			return bound < other.bound;
+		}
+	};
+
+	static bool score_equal(const score_type& a, const score_type& b)
+	{
+		return !(a < b) && !(b < a);
+	}
+
+	// the highest score among the key of node and the subtrees of its children
+	static score_type subtree_max_of(node_ptr node)
+	{
+		bool found = !node->no_value();
+		score_type m = found ? node->value.score : score_type();
+		for (node_ptr c = node->children.front(); c != NULL; c = node->children.next(c))
+		{
+			if (!found || m < c->value.subtree_max)
+				m = c->value.subtree_max;
+			found = true;
+		}
+		return m;
+	}
+
+	// recompute the maxima from node up, until one does not change
+	static void update_max(node_ptr node)
+	{
+		for (node_ptr cur = node; cur != NULL; cur = cur->parent)
+		{
+			score_type m = subtree_max_of(cur);
+			if (cur != node && score_equal(m, cur->value.subtree_max))
+				break;
+			cur->value.subtree_max = m;
+		}
+	}
+
+	// node just took its key with score: its ancestors only ever go up,
+	// except that those with no other key in their subtree are new
+	static void raise_max(node_ptr node, const score_type& score)
+	{
+		node->value.subtree_max = subtree_max_of(node);
+		for (node_ptr cur = node->parent; cur != NULL; cur = cur->parent)
+		{
+			if (cur->value_count == 1)
+				cur->value.subtree_max = score;
+			else if (cur->value.subtree_max < score)
+				cur->value.subtree_max = score;
+			else
+				break;
+		}
+	}
+
+public:
+	explicit scored_trie_map(const allocator_type& alloc = allocator_type()) : t(alloc)
+	{
+	}
+
+	explicit scored_trie_map(const scored_trie_map_type& other) : t(other.t)
+	{
+	}
+
+	scored_trie_map_type& operator=(const scored_trie_map_type& other)
+	{
+		t = other.t;
+		return *this;
+	}
+
+	allocator_type get_allocator() const
+	{
+		return t.get_allocator();
+	}
+
+	const_iterator begin() const
+	{
+		return t.begin();
+	}
+
+	const_iterator end() const
+	{
+		return t.end();
+	}
+
+	const_reverse_iterator rbegin() const
+	{
+		return t.rbegin();
+	}
+
+	const_reverse_iterator rend() const
+	{
+		return t.rend();
+	}
+
+// modifying functions
+
+	// insert a key with its score; a key already there keeps its score
+	template<typename Iter>
+	pair_iterator_bool insert(Iter first, Iter last, const score_type& score)
+	{
+		typename trie_type::pair_iterator_bool r = t.insert_unique(first, last, value_type(score));
+		if (r.second)
+			raise_max(r.first.tnode, score);
+		return pair_iterator_bool(r.first, r.second);
+	}
+
+	template<typename Container>
+	pair_iterator_bool insert(const Container& container, const score_type& score)
+	{
+		return insert(container.begin(), container.end(), score);
+	}
+
+	// insert a key or change its score
+	template<typename Iter>
+	const_iterator set_score(Iter first, Iter last, const score_type& score)
+	{
+		pair_iterator_bool r = insert(first, last, score);
+		if (!r.second)
+		{
+			node_ptr node = r.first.tnode;
+			score_type old = node->value.score;
+			node->value.score = score;
+			if (old < score)
+				raise_max(node, score);
+			else
+				update_max(node);
+		}
+		return r.first;
+	}
+
+	template<typename Container>
+	const_iterator set_score(const Container& container, const score_type& score)
+	{
+		return set_score(container.begin(), container.end(), score);
+	}
+
+	const_iterator erase(const_iterator it)
+	{
+		node_ptr node = it.tnode;
+		// the deepest node that stays, having another key in its subtree
+		node_ptr kept = node;
+		while (kept->parent != NULL && kept->value_count == 1)
+			kept = kept->parent;
+		const_iterator next = t.erase(it);
+		update_max(kept);
+		return next;
+	}
+
+	template<typename Iter>
+	const_iterator erase(Iter first, Iter last)
+	{
+		const_iterator it = find(first, last);
+		if (it == end())
+			return it;
+		return erase(it);
+	}
+
+	template<typename Container>
+	const_iterator erase(const Container& container)
+	{
+		return erase(container.begin(), container.end());
+	}
+
+	void swap(scored_trie_map_type& other)
+	{
+		t.swap(other.t);
+	}
+
+	void clear()
+	{
+		t.clear();
+	}
+
+	// clear() releasing an arena_allocator's chunks even while the caller
+	// keeps a copy of the allocator; nothing else may use the arena
+	void release_arena()
+	{
+		t.release_arena();
+	}
+
+// query functions
+
+	template<typename Iter>
+	const_iterator find(Iter first, Iter last)
+	{
+		return t.find(first, last);
+	}
+
+	template<typename Container>
+	const_iterator find(const Container& container)
+	{
+		return t.find(container);
+	}
+
+	template<typename Iter>
+	size_type count(Iter first, Iter last)
+	{
+		return t.count(first, last);
+	}
+
+	template<typename Container>
+	size_type count(const Container& container)
+	{
+		return t.count(container);
+	}
+
+	template<typename Iter>
+	iterator_range find_prefix(Iter first, Iter last)
+	{
+		return t.find_prefix(first, last);
+	}
+
+	template<typename Container>
+	iterator_range find_prefix(const Container& container)
+	{
+		return t.find_prefix(container);
+	}
+
+	template<typename Iter>
+	size_type count_prefix(Iter first, Iter last)
+	{
+		return t.count_prefix(first, last);
+	}
+
+	template<typename Container>
+	size_type count_prefix(const Container& container)
+	{
+		return t.count_prefix(container);
+	}
+
+	/*
+	 * Write iterators to the k keys with the highest scores under the
+	 * prefix [first, last) to out, highest first; ties come in no
+	 * particular order.
+	 */
+	template<typename Iter, typename OutIter>
+	OutIter top_k(Iter first, Iter last, size_type k, OutIter out)
+	{
+		node_ptr node = t.find_node(first, last);
+		if (node == NULL || k == 0 || node->value_count == 0)
+			return out;
+		std::priority_queue<search_entry> open;
+		search_entry e = { node->value.subtree_max, node, false };
+		open.push(e);
+		while (k > 0 && !open.empty())
+		{
+			e = open.top();
+			open.pop();
+			if (e.is_key)
+			{
+				*out++ = const_iterator(e.node);
+				--k;
+				continue;
+			}
+			node = e.node;
+			if (!node->no_value())
+			{
+				search_entry key = { node->value.score, node, true };
+				open.push(key);
+			}
+			for (node_ptr c = node->children.front(); c != NULL; c = node->children.next(c))
+			{
+				search_entry child = { c->value.subtree_max, c, false };
+				open.push(child);
+			}
+		}
+		return out;
+	}
+
+	template<typename Container, typename OutIter>
+	OutIter top_k(const Container& container, size_type k, OutIter out)
+	{
+		return top_k(container.begin(), container.end(), k, out);
+	}
+
+	size_type size() const
+	{
+		return t.size();
+	}
+
+	bool empty() const
+	{
+		return t.empty();
+	}
+
+	size_type count_node() const
+	{
+		return t.count_node();
+	}
+};
+
+}	// namespace tries
+}	// namespace boost
+#endif
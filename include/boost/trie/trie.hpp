@@ -6,16 +6,33 @@
 #endif
 
 #include <stack>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <memory>
+#include <iterator>
+#include <stdexcept>
 #include <boost/trie/detail/trie_node.hpp>
 #include <boost/trie/detail/trie_iterator.hpp>
+#include <boost/trie/detail/trie_cursor.hpp>
+#include <boost/trie/detail/prefix_cursor.hpp>
+#include <boost/trie/detail/node_arena.hpp>
+#include <boost/trie/detail/node_pool.hpp>
+#include <boost/trie/detail/prefetch.hpp>
+#include <boost/trie/detail/glob_pattern.hpp>
 #include <boost/static_assert.hpp>
 #include <boost/type_traits/is_void.hpp>
+#include <boost/type_traits/has_trivial_destructor.hpp>
+#include <boost/type_traits/integral_constant.hpp>
 #include <boost/mpl/if.hpp>
 #include <boost/blank.hpp>
+#include <boost/container/allocator_traits.hpp>
 
 namespace boost { namespace tries {
 
-template <typename Key, typename Value, bool multi_value_node = true>
+template <typename Key, typename Value, bool multi_value_node = true,
+	typename ChildPolicy = adaptive_children_policy,
+	typename Allocator = std::allocator<Key> >
 class trie {
 public:
 	typedef Key key_type;
@@ -27,38 +44,72 @@ public:
 	>::type non_void_value_type;
 	typedef Value value_type;
 	typedef value_type* value_ptr;
-	typedef trie<key_type, Value, multi_value_node> trie_type;
-	typedef typename detail::trie_node<key_type, value_type, multi_value_node> node_type;
+	typedef ChildPolicy child_policy;
+	typedef Allocator allocator_type;
+	typedef trie<key_type, Value, multi_value_node, child_policy, allocator_type> trie_type;
+	typedef typename detail::trie_node<key_type, value_type, multi_value_node, child_policy> node_type;
 	typedef node_type * node_ptr;
-	typedef typename detail::value_list_node<key_type, value_type> value_node_type;
-	typedef value_node_type * value_node_ptr;
 	typedef size_t size_type;
-	typedef std::allocator<node_type> node_alloc_type;
-	typedef std::allocator<value_node_type> value_alloc_type;
-	typedef detail::comparator comparator;
+	// nodes and spilled value arrays come from the user allocator, rebound
+	typedef typename detail::rebind_alloc<allocator_type, node_type>::type node_alloc_type;
+	typedef typename detail::rebind_alloc<allocator_type, non_void_value_type>::type value_alloc_type;
+	typedef boost::container::allocator_traits<node_alloc_type> node_alloc_traits;
 	typedef detail::value_remove_helper<node_type, value_alloc_type, multi_value_node> value_remove_helper;
 	typedef detail::value_copy_helper<node_type, value_alloc_type, multi_value_node> value_copy_helper;
+	typedef detail::arena_hooks<node_alloc_type> arena_hooks;
 
 private:
 	value_remove_helper remove_values_from;
 	value_copy_helper copy_values;
 	node_alloc_type node_allocator;
 	value_alloc_type value_allocator;
-	comparator node_comparator;
+	detail::node_free_list<node_type> free_nodes;
+
+	// the allocators above, all a trie holds for as long as it lives
+	static const size_type allocator_copies = 2;
 
 	node_type root;
 	size_type node_count; // node_count is difficult and useless to maintain on each node, so, put it on the tree
 
+	node_ptr allocate_trie_node()
+	{
+		node_ptr new_node = free_nodes.pop();
+		if (new_node == NULL)
+			new_node = node_alloc_traits::allocate(node_allocator, 1);
+		return new_node;
+	}
+
 	node_ptr create_trie_node()
 	{
-		node_ptr new_node = node_allocator.allocate(1);
-		return new(new_node) node_type();
+		return new(allocate_trie_node()) node_type();
 	}
 
 	node_ptr create_trie_node(const key_type& key)
 	{
-		node_ptr new_node = node_allocator.allocate(1);
-		return new(new_node) node_type(key);
+		return new(allocate_trie_node()) node_type(key);
+	}
+
+	// a children container that may refuse a key is asked about every new
+	// element before the first node is made, so a refused key leaves no
+	// half built path behind
+	template<typename Iter>
+	static void check_new_elements(Iter first, Iter last, boost::true_type)
+	{
+		for (; first != last; ++first)
+			if (!node_type::children_type::accepts(*first))
+				throw std::out_of_range("trie: key element out of range of the child policy");
+	}
+
+	template<typename Iter>
+	static void check_new_elements(Iter, Iter, boost::false_type)
+	{
+	}
+
+	template<typename Iter>
+	static void check_new_elements(Iter first, Iter last)
+	{
+		check_new_elements(first, last,
+			detail::children_reject_keys<typename node_type::children_type>());
 	}
 
 	void destroy_trie_node(node_ptr node)
@@ -68,8 +119,9 @@ private:
 			remove_values_from(node, value_allocator);
 		else
 			remove_values_from(node);
-		node_allocator.destroy(node);
-		node_allocator.deallocate(node, 1);
+		node_alloc_traits::destroy(node_allocator, node);
+		if (!free_nodes.push(node))
+			node_alloc_traits::deallocate(node_allocator, node, 1);
 	}
 
 	// need constant time to get leftmost
@@ -78,34 +130,24 @@ private:
 		node_ptr cur = node;
 		while (!cur->children.empty() && cur->no_value())
 		{
-			cur = &(*(cur->children.begin()));
+			cur = cur->children.front();
 		}
 		return cur;
 	}
 
-	/*value_node_ptr leftmost_value(node_ptr node) const
+	// first node with a value after the whole sub-trie of node
+	node_ptr next_subtree(node_ptr node) const
 	{
-		node = leftmost_node(node);
-		return static_cast<value_node_ptr>(node->value_list_header);
-	}*/
-
-	// need constant time to get rightmost
-	node_ptr rightmost_node(node_ptr node) const
-	{
-		node_ptr cur = node;
-		while (!cur->children.empty())
+		while (node->parent != NULL)
 		{
-			cur = &(*(cur->children.rbegin()));
+			node_ptr sibling = node->parent->children.next(node);
+			if (sibling != NULL)
+				return leftmost_node(sibling);
+			node = node->parent;
 		}
-		return cur;
+		return node;
 	}
 
-	/*value_node_ptr rightmost_value(node_ptr node) const
-	{
-		node = rightmost_node(node);
-		return static_cast<value_node_ptr>(node->value_list_tail);
-	}*/
-
 	// copy the whole trie tree
 	void copy_tree(node_ptr other_root)
 	{
@@ -117,21 +159,21 @@ private:
 		// but inserting one by one need key, so it is hard to do that
 
 		std::stack<node_ptr> other_node_stk, self_node_stk;
-		std::stack<typename node_type::children_iter> ci_stk;
+		std::stack<node_ptr> ci_stk;
 		other_node_stk.push(other_root);
 		self_node_stk.push(&root);
-		ci_stk.push(other_root->children.begin());
+		ci_stk.push(other_root->children.front());
 		for (; !other_node_stk.empty(); )
 		{
 			node_ptr other_cur = other_node_stk.top();
 			node_ptr self_cur = self_node_stk.top();
-			if (ci_stk.top() == other_cur->children.end())
+			if (ci_stk.top() == NULL)
 			{
 				other_node_stk.pop();
 				ci_stk.pop();
 				self_node_stk.pop();
 			} else {
-				node_ptr c = &(*ci_stk.top());
+				node_ptr c = ci_stk.top();
 				// create new node
 				node_ptr new_node = create_trie_node(c->key);
 				if (new_node != NULL)
@@ -141,11 +183,11 @@ private:
 				else
 					copy_values(new_node, c);
 				new_node->parent = self_cur;
-				self_cur->children.insert(*new_node);
+				self_cur->children.insert(new_node, node_allocator);
 				// to next node
-				++ci_stk.top();
+				ci_stk.top() = other_cur->children.next(c);
 				other_node_stk.push(c);
-				ci_stk.push(c->children.begin());
+				ci_stk.push(c->children.front());
 				self_node_stk.push(new_node);
 			}
 		}
@@ -155,6 +197,113 @@ private:
 			copy_values(&root, other_root);
 	}
 
+	enum { batch_group_size = 16 };
+
+	// walk up to batch_group_size keys from first side by side, one level
+	// per round, prefetching the node each of them moves to; the found
+	// nodes, or NULL, go to result. Returns how many keys were taken.
+	template<typename KeyIter>
+	size_type find_node_group(KeyIter& first, KeyIter last, node_ptr *result)
+	{
+		typedef typename std::iterator_traits<KeyIter>::value_type container_type;
+		typedef typename container_type::const_iterator elem_iter;
+		elem_iter pos[batch_group_size], stop[batch_group_size];
+		size_type n = 0;
+		for (; n < batch_group_size && first != last; ++n, ++first)
+		{
+			const container_type& key = *first;
+			result[n] = &root;
+			pos[n] = key.begin();
+			stop[n] = key.end();
+		}
+		size_type active = n;
+		while (active != 0)
+		{
+			active = 0;
+			for (size_type i = 0; i < n; ++i)
+			{
+				if (result[i] == NULL || pos[i] == stop[i])
+					continue;
+				node_ptr child = result[i]->children.find(*pos[i]);
+				result[i] = child;
+				if (child != NULL && ++pos[i] != stop[i])
+				{
+					detail::prefetch_read(child);
+					++active;
+				}
+			}
+		}
+		return n;
+	}
+
+	// how much of the path of a hint is followed, kept on the stack; a
+	// deeper hint is used through its ancestor at this depth
+	enum { hint_depth_limit = 64 };
+
+	// the deepest node on the path of [first, last), moving first past its
+	// elements; those shared with the key of hint follow the path of hint
+	template<typename Iter>
+	node_ptr descend_from_hint(node_ptr hint, Iter& first, Iter last)
+	{
+		size_type depth = 0;
+		for (node_ptr cur = hint; cur->parent != NULL; cur = cur->parent)
+			++depth;
+		for (; depth > hint_depth_limit; --depth)
+			hint = hint->parent;
+		// path[d] is the node of the first d + 1 elements of the hint
+		node_ptr path[hint_depth_limit];
+		for (size_type d = depth; d > 0; --d, hint = hint->parent)
+			path[d - 1] = hint;
+		node_ptr cur = &root;
+		for (size_type d = 0; d < depth && first != last; ++first, ++d)
+		{
+			const key_type& elem = path[d]->key_elem();
+			if (elem < *first || *first < elem)
+				break;
+			cur = path[d];
+		}
+		for (; first != last; ++first)
+		{
+			node_ptr child = cur->children.find(*first);
+			if (child == NULL)
+				break;
+			cur = child;
+		}
+		return cur;
+	}
+
+	// find_node() for key when path holds the nodes of the key prev, path[d]
+	// the node of its first d elements; path is left holding those of key
+	template<typename Container>
+	node_ptr find_node_from_path(std::vector<node_ptr>& path, const Container *prev,
+			const Container& key)
+	{
+		typedef typename Container::const_iterator elem_iter;
+		elem_iter pos = key.begin(), stop = key.end();
+		size_type depth = 0;
+		if (prev != NULL)
+		{
+			elem_iter p = prev->begin(), prev_stop = prev->end();
+			while (depth + 1 < path.size() && pos != stop && p != prev_stop
+					&& !(*pos < *p) && !(*p < *pos))
+			{
+				++depth;
+				++pos;
+				++p;
+			}
+			path.resize(depth + 1);
+		}
+		node_ptr cur = path[depth];
+		for (; pos != stop; ++pos)
+		{
+			cur = cur->children.find(*pos);
+			if (cur == NULL)
+				break;
+			path.push_back(cur);
+		}
+		return cur;
+	}
+
 	node_ptr next_node_with_value(node_ptr tnode)
 	{
 		// at iterator end
@@ -164,7 +313,7 @@ private:
 		if (!cur->children.empty())
 		{ // go down to the first node with a value in it, and there always be at least one
 			do {
-				cur = &(*(cur->children.begin()));
+				cur = cur->children.front();
 			} while (cur->no_value());
 			tnode = cur;
 		} else {
@@ -173,14 +322,13 @@ private:
 			while (cur->parent != NULL)
 			{
 				node_ptr p = cur->parent;
-				typename node_type::children_iter ci = p->children.iterator_to(*cur);
-				++ci;
-				if (ci != p->children.end())
+				node_ptr sibling = p->children.next(cur);
+				if (sibling != NULL)
 				{
-					cur = &(*ci);
+					cur = sibling;
 					//"change value to self_value_count
 					while (cur->no_value()) {
-						cur = &(*(cur->children.begin()));
+						cur = cur->children.front();
 					}
 					break;
 				}
@@ -195,14 +343,16 @@ private:
 public:
 	// iterators still unavailable here
 
-	explicit trie() : node_allocator(), value_allocator(),
-		node_count(0)
+	explicit trie(const allocator_type& alloc = allocator_type()) : node_allocator(alloc),
+		value_allocator(alloc), node_count(0)
 	{
 	}
 
-	explicit trie(const trie_type& t) : node_allocator(), value_allocator(),
-		node_count(0)
+	explicit trie(const trie_type& t) :
+		node_allocator(node_alloc_traits::select_on_container_copy_construction(t.node_allocator)),
+		value_allocator(node_allocator), node_count(0)
 	{
+		set_free_list_cap(t.free_list_cap());
 		copy_tree(const_cast<node_ptr>(&t.root));
 	}
 
@@ -212,12 +362,21 @@ public:
 		return *this;
 	}
 
-	typedef detail::trie_iterator<Key, Value, multi_value_node> iterator;
+	allocator_type get_allocator() const
+	{
+		return allocator_type(node_allocator);
+	}
+
+	typedef detail::trie_iterator<Key, Value, multi_value_node, child_policy> iterator;
 	typedef typename iterator::const_iterator const_iterator;
 	typedef std::reverse_iterator<iterator> reverse_iterator;
 	typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
 	typedef std::pair<iterator, bool> pair_iterator_bool;
 	typedef std::pair<iterator, iterator> iterator_range;
+	typedef detail::trie_cursor<Key, Value, multi_value_node, child_policy> cursor;
+	typedef detail::trie_cursor<Key, const Value, multi_value_node, child_policy> const_cursor;
+	typedef detail::prefix_cursor<Key, Value, multi_value_node, child_policy> prefix_cursor;
+	typedef detail::prefix_cursor<Key, const Value, multi_value_node, child_policy> const_prefix_cursor;
 
 	iterator begin()
 	{
@@ -249,6 +408,28 @@ public:
 		return const_cast<node_ptr>(&root);
 	}
 
+	// a cursor at the first key, see trie_cursor
+	cursor begin_cursor()
+	{
+		return cursor(leftmost_node(&root));
+	}
+
+	const_cursor begin_cursor() const
+	{
+		return const_cursor(leftmost_node(const_cast<node_ptr>(&root)));
+	}
+
+	// a cursor at the empty prefix, see prefix_cursor
+	prefix_cursor begin_prefix_cursor()
+	{
+		return prefix_cursor(&root);
+	}
+
+	const_prefix_cursor begin_prefix_cursor() const
+	{
+		return const_prefix_cursor(const_cast<node_ptr>(&root));
+	}
+
 	reverse_iterator rbegin()
 	{
 		return static_cast<reverse_iterator>(end());
@@ -281,13 +462,14 @@ public:
 
 	template<typename Iter>
 	void __insert(node_ptr& cur, Iter& first, Iter last) {
+		check_new_elements(first, last);
 		for (; first != last; ++first)
 		{
 			const key_type& cur_key = *first;
 			node_ptr new_node = create_trie_node(cur_key);
 			node_count++;
 			new_node->parent = cur;
-			cur->children.insert(*new_node);
+			cur->children.insert(new_node, node_allocator);
 			cur = new_node;
 		}
 	}
@@ -321,7 +503,7 @@ public:
 				++tmp->value_count;
 				tmp = tmp->parent;
 			}
-			return cur->value_list_header;
+			return cur;
 		}
 
 	template<typename Iter>
@@ -334,23 +516,24 @@ public:
 			for (; first != last; ++first)
 			{
 				const key_type& cur_key = *first;
-				typename node_type::children_iter ci = cur->children.find(cur_key, node_comparator);
-				if (ci == cur->children.end())
+				node_ptr child = cur->children.find(cur_key);
+				if (child == NULL)
 					break;
-				cur = &(*ci);
+				cur = child;
 			}
 
 			if (first == last && !cur->no_value()) {
 				return std::make_pair(iterator(cur), false);
 			}
 
+			check_new_elements(first, last);
 			for (; first != last; ++first)
 			{
 				const key_type& cur_key = *first;
 				node_ptr new_node = create_trie_node(cur_key);
 				node_count++;
 				new_node->parent = cur;
-				cur->children.insert(*new_node);
+				cur->children.insert(new_node, node_allocator);
 				cur = new_node;
 			}
 
@@ -382,12 +565,12 @@ public:
 			for (; first != last; ++first)
 			{
 				const key_type& cur_key = *first;
-				typename node_type::children_iter ci = cur->children.find(cur_key, node_comparator);
-				if (ci == cur->children.end())
+				node_ptr child = cur->children.find(cur_key);
+				if (child == NULL)
 				{
 					return std::make_pair(__insert_single_value(cur, first, last, value), true);
 				}
-				cur = &(*ci);
+				cur = child;
 			}
 
 			if (cur->no_value())
@@ -412,12 +595,12 @@ public:
 			for (; first != last; ++first)
 			{
 				const key_type& cur_key = *first;
-				typename node_type::children_iter ci = cur->children.find(cur_key, node_comparator);
-				if (ci == cur->children.end())
+				node_ptr child = cur->children.find(cur_key);
+				if (child == NULL)
 				{
 					return __insert_multiple_value(cur, first, last, value);
 				}
-				cur = &(*ci);
+				cur = child;
 			}
 			return __insert_multiple_value(cur, first, last, value);
 		}
@@ -428,6 +611,67 @@ public:
 			return insert_equal(container.begin(), container.end(), value);
 		}
 
+	/*
+	 * Inserts resuming from the path of hint, usually what the previous
+	 * insert returned: the elements the key shares with the key of hint
+	 * are matched against that path, found through the parent pointers,
+	 * rather than looked up among children. For sorted or clustered input
+	 * most of the path is shared. Any hint in this trie gives the same
+	 * result as the insert without one, end() the same cost.
+	 */
+	template<typename Iter>
+		iterator insert_unique(const_iterator hint, Iter first, Iter last)
+		{
+			BOOST_STATIC_ASSERT_MSG(boost::is_void<Value>::value,
+					"Value template parameter should be void");
+			node_ptr cur = descend_from_hint(hint.tnode, first, last);
+			if (first == last && !cur->no_value())
+				return cur;
+			__insert(cur, first, last);
+			cur->key_ends_here = true;
+			for (node_ptr tmp = cur; tmp != NULL; tmp = tmp->parent)
+				++tmp->value_count;
+			return cur;
+		}
+
+	template<typename Container>
+		iterator insert_unique(const_iterator hint, const Container &container)
+		{
+			return insert_unique(hint, container.begin(), container.end());
+		}
+
+	template<typename Iter>
+		iterator insert_unique(const_iterator hint, Iter first, Iter last,
+				const non_void_value_type& value)
+		{
+			node_ptr cur = descend_from_hint(hint.tnode, first, last);
+			if (first == last && !cur->no_value())
+				return cur;
+			return __insert_single_value(cur, first, last, value);
+		}
+
+	template<typename Container>
+		iterator insert_unique(const_iterator hint, const Container &container,
+				const non_void_value_type& value)
+		{
+			return insert_unique(hint, container.begin(), container.end(), value);
+		}
+
+	template<typename Iter>
+		iterator insert_equal(const_iterator hint, Iter first, Iter last,
+				const non_void_value_type& value)
+		{
+			node_ptr cur = descend_from_hint(hint.tnode, first, last);
+			return __insert_multiple_value(cur, first, last, value);
+		}
+
+	template<typename Container>
+		iterator insert_equal(const_iterator hint, const Container &container,
+				const non_void_value_type& value)
+		{
+			return insert_equal(hint, container.begin(), container.end(), value);
+		}
+
 	template<typename Iter>
 		node_ptr find_node(Iter first, Iter last)
 		{
@@ -435,12 +679,12 @@ public:
 			for (; first != last; ++first)
 			{
 				const key_type& cur_key = *first;
-				typename node_type::children_iter ci = cur->children.find(cur_key, node_comparator);
-				if (ci == cur->children.end())
+				node_ptr child = cur->children.find(cur_key);
+				if (child == NULL)
 				{
 					return NULL;
 				}
-				cur = &(*ci);
+				cur = child;
 			}
 			return cur;
 		}
@@ -482,6 +726,99 @@ public:
 			return count(container.begin(), container.end());
 		}
 
+	/*
+	 * Batch lookups over a range of key containers, one result per key,
+	 * in order. The walks of a group of keys are interleaved so that their
+	 * cache misses overlap; this pays off for tries bigger than the cache.
+	 * KeyIter must be a forward iterator whose operator* returns a reference.
+	 */
+	template<typename KeyIter, typename OutIter>
+		OutIter find_node_batch(KeyIter first, KeyIter last, OutIter out)
+		{
+			node_ptr found[batch_group_size];
+			while (first != last)
+			{
+				size_type n = find_node_group(first, last, found);
+				for (size_type i = 0; i < n; ++i)
+					*out++ = found[i];
+			}
+			return out;
+		}
+
+	template<typename KeyIter, typename OutIter>
+		OutIter find_batch(KeyIter first, KeyIter last, OutIter out)
+		{
+			node_ptr found[batch_group_size];
+			while (first != last)
+			{
+				size_type n = find_node_group(first, last, found);
+				for (size_type i = 0; i < n; ++i)
+				{
+					if (found[i] == NULL || found[i]->no_value())
+						*out++ = end();
+					else
+						*out++ = iterator(found[i]);
+				}
+			}
+			return out;
+		}
+
+	template<typename KeyIter, typename OutIter>
+		OutIter count_batch(KeyIter first, KeyIter last, OutIter out)
+		{
+			node_ptr found[batch_group_size];
+			while (first != last)
+			{
+				size_type n = find_node_group(first, last, found);
+				for (size_type i = 0; i < n; ++i)
+					*out++ = found[i] == NULL ? 0 : found[i]->count();
+			}
+			return out;
+		}
+
+	/*
+	 * Batch lookups that keep the path of the previous key and walk back
+	 * only to where the next key leaves it, so a shared prefix costs
+	 * element compares instead of child lookups. Any order of keys gives
+	 * the right results; sorted keys share the most. KeyIter must be a
+	 * forward iterator whose operator* returns a reference.
+	 */
+	template<typename KeyIter, typename OutIter>
+		OutIter find_node_sorted_batch(KeyIter first, KeyIter last, OutIter out)
+		{
+			std::vector<node_ptr> path(1, &root);
+			for (KeyIter prev = last; first != last; prev = first, ++first)
+				*out++ = find_node_from_path(path, prev == last ? NULL : &*prev, *first);
+			return out;
+		}
+
+	template<typename KeyIter, typename OutIter>
+		OutIter find_sorted_batch(KeyIter first, KeyIter last, OutIter out)
+		{
+			std::vector<node_ptr> path(1, &root);
+			for (KeyIter prev = last; first != last; prev = first, ++first)
+			{
+				node_ptr node = find_node_from_path(path, prev == last ? NULL : &*prev, *first);
+				if (node == NULL || node->no_value())
+					*out++ = end();
+				else
+					*out++ = iterator(node);
+			}
+			return out;
+		}
+
+	template<typename KeyIter, typename OutIter>
+		OutIter count_prefix_sorted_batch(KeyIter first, KeyIter last, OutIter out)
+		{
+			std::vector<node_ptr> path(1, &root);
+			for (KeyIter prev = last; first != last; prev = first, ++first)
+			{
+				node_ptr node = find_node_from_path(path, prev == last ? NULL : &*prev, *first);
+				*out++ = node == NULL ? 0 : node->value_count;
+			}
+			return out;
+		}
+
 	// find by prefix, return a pair of iterator(begin, end)
 	template<typename Iter>
 		iterator_range find_prefix(Iter first, Iter last)
@@ -491,13 +828,9 @@ public:
 			{
 				return std::make_pair(end(), end());
 			}
-			iterator begin = leftmost_node(node);
-			// optimization is needed here
-			node = rightmost_node(node);
-			iterator end(node);
-			while(end.tnode == node)
-				++end;
-			return std::make_pair(begin, end);
+			// both ends are one walk of at most the depth of the trie, the
+			// values of the last node are never stepped through
+			return std::make_pair(iterator(leftmost_node(node)), iterator(next_subtree(node)));
 		}
 
 	template<typename Container>
@@ -506,6 +839,201 @@ public:
 			return find_prefix(container.begin(), container.end());
 		}
 
+	// the deepest node with a value on the path of [first, last), with its
+	// depth, which is the length of the matched key; (end(), 0) if none
+	template<typename Iter>
+		std::pair<iterator, size_type> longest_prefix_match(Iter first, Iter last)
+		{
+			node_ptr cur = &root;
+			node_ptr match = &root;
+			size_type depth = 0, match_depth = 0;
+			for (; first != last; ++first)
+			{
+				cur = cur->children.find(*first);
+				if (cur == NULL)
+					break;
+				++depth;
+				if (!cur->no_value())
+				{
+					match = cur;
+					match_depth = depth;
+				}
+			}
+			return std::make_pair(iterator(match), match_depth);
+		}
+
+	template<typename Container>
+		std::pair<iterator, size_type> longest_prefix_match(const Container &container)
+		{
+			return longest_prefix_match(container.begin(), container.end());
+		}
+
+	// write an iterator to every value whose key is a prefix of
+	// [first, last) to out, shortest key first, in one walk down
+	template<typename Iter, typename OutIter>
+		OutIter prefixes_of(Iter first, Iter last, OutIter out)
+		{
+			node_ptr cur = &root;
+			for (; first != last; ++first)
+			{
+				cur = cur->children.find(*first);
+				if (cur == NULL)
+					break;
+				for (size_type i = 0; i < cur->count(); ++i)
+					*out++ = iterator_at(cur, i, boost::integral_constant<bool, multi_value_node>());
+			}
+			return out;
+		}
+
+	template<typename Container, typename OutIter>
+		OutIter prefixes_of(const Container &container, OutIter out)
+		{
+			return prefixes_of(container.begin(), container.end(), out);
+		}
+
+	/*
+	 * Write (iterator, distance) for every value whose key is within
+	 * max_distance edits (insertions, deletions, substitutions) of
+	 * [first, last) to out, in key order. One walk carries a row of the
+	 * Levenshtein table down each branch and leaves a subtree as soon as
+	 * every entry of the row is over the bound.
+	 */
+	template<typename Iter, typename OutIter>
+		OutIter fuzzy_find(Iter first, Iter last, size_type max_distance, OutIter out)
+		{
+			const std::vector<key_type> query(first, last);
+			const size_type width = query.size() + 1;
+			// row d is the table row of the node at depth d on the walk
+			std::vector<size_type> rows(width);
+			for (size_type j = 0; j < width; ++j)
+				rows[j] = j;
+			node_ptr cur = root.children.front();
+			size_type depth = 1;
+			while (cur != NULL)
+			{
+				if (rows.size() < (depth + 1) * width)
+					rows.resize((depth + 1) * width);
+				const size_type *above = &rows[(depth - 1) * width];
+				size_type *row = &rows[depth * width];
+				const key_type& elem = cur->key_elem();
+				row[0] = depth;
+				size_type row_min = row[0];
+				for (size_type j = 1; j < width; ++j)
+				{
+					size_type subst = above[j - 1]
+						+ ((query[j - 1] < elem || elem < query[j - 1]) ? 1 : 0);
+					row[j] = std::min(std::min(above[j], row[j - 1]) + 1, subst);
+					row_min = std::min(row_min, row[j]);
+				}
+				if (!cur->no_value() && row[width - 1] <= max_distance)
+				{
+					for (size_type i = 0; i < cur->count(); ++i)
+						*out++ = std::make_pair(iterator_at(cur, i,
+							boost::integral_constant<bool, multi_value_node>()), row[width - 1]);
+				}
+				if (row_min <= max_distance && !cur->children.empty())
+				{
+					cur = cur->children.front();
+					++depth;
+					continue;
+				}
+				// climb to the first ancestor with a next sibling
+				while (cur != &root)
+				{
+					node_ptr sibling = cur->parent->children.next(cur);
+					if (sibling != NULL)
+					{
+						cur = sibling;
+						break;
+					}
+					cur = cur->parent;
+					--depth;
+				}
+				if (cur == &root)
+					break;
+			}
+			return out;
+		}
+
+	template<typename Container, typename OutIter>
+		OutIter fuzzy_find(const Container &container, size_type max_distance, OutIter out)
+		{
+			return fuzzy_find(container.begin(), container.end(), max_distance, out);
+		}
+
+	/*
+	 * Write an iterator to every value whose key matches the glob pattern
+	 * [first, last) to out, in key order; see detail::glob_pattern for the
+	 * syntax. The set of pattern positions is stepped along each edge and
+	 * a subtree is left when it becomes empty; where only a literal can
+	 * come next, its child is looked up instead of visiting every child.
+	 */
+	template<typename Iter, typename OutIter>
+		OutIter match_pattern(Iter first, Iter last, OutIter out)
+		{
+			const detail::glob_pattern<key_type> pattern(first, last);
+			const size_type width = pattern.width();
+			// sets[d] is the position set at depth d, direct[d] the literal
+			// the children of the node at depth d are looked up by, or NULL
+			// when they are all visited
+			std::vector<char> sets(width);
+			std::vector<const key_type *> direct(1);
+			pattern.start(&sets[0]);
+			direct[0] = pattern.only_literal(&sets[0]);
+			node_ptr cur = direct[0] != NULL ? root.children.find(*direct[0])
+				: root.children.front();
+			size_type depth = 1;
+			while (cur != NULL)
+			{
+				if (sets.size() < (depth + 1) * width)
+				{
+					sets.resize((depth + 1) * width);
+					direct.resize(depth + 1);
+				}
+				char *set = &sets[depth * width];
+				if (pattern.step(&sets[(depth - 1) * width], set, cur->key_elem()))
+				{
+					if (!cur->no_value() && pattern.accepting(set))
+					{
+						for (size_type i = 0; i < cur->count(); ++i)
+							*out++ = iterator_at(cur, i,
+								boost::integral_constant<bool, multi_value_node>());
+					}
+					direct[depth] = pattern.only_literal(set);
+					node_ptr child = direct[depth] != NULL ? cur->children.find(*direct[depth])
+						: cur->children.front();
+					if (child != NULL)
+					{
+						cur = child;
+						++depth;
+						continue;
+					}
+				}
+				// climb to the first ancestor with a next sibling to match
+				while (cur != &root)
+				{
+					node_ptr sibling = direct[depth - 1] != NULL ? NULL
+						: cur->parent->children.next(cur);
+					if (sibling != NULL)
+					{
+						cur = sibling;
+						break;
+					}
+					cur = cur->parent;
+					--depth;
+				}
+				if (cur == &root)
+					break;
+			}
+			return out;
+		}
+
+	template<typename Container, typename OutIter>
+		OutIter match_pattern(const Container &container, OutIter out)
+		{
+			return match_pattern(container.begin(), container.end(), out);
+		}
+
 	// count_prefix() to count values with the same prefix
 	template<typename Iter>
 		size_type count_prefix(Iter first, Iter last)
@@ -524,6 +1052,119 @@ public:
 			return count_prefix(container.begin(), container.end());
 		}
 
+	// number of values with a key less than [first, last), in
+	// O(depth * fanout) from the value_count of the children passed by
+	template<typename Iter>
+		size_type rank(Iter first, Iter last)
+		{
+			node_ptr cur = &root;
+			size_type less = 0;
+			for (; first != last; ++first)
+			{
+				if (cur != &root)
+					less += cur->count();
+				node_ptr c = cur->children.front();
+				for (; c != NULL && c->key_elem() < *first; c = cur->children.next(c))
+					less += c->value_count;
+				if (c == NULL || *first < c->key_elem())
+					break;
+				cur = c;
+			}
+			return less;
+		}
+
+	template<typename Container>
+		size_type rank(const Container &container)
+		{
+			return rank(container.begin(), container.end());
+		}
+
+	// number of values with a key in [lo, hi), two rank() walks
+	template<typename Iter>
+		size_type count_range(Iter lo_first, Iter lo_last, Iter hi_first, Iter hi_last)
+		{
+			size_type below_lo = rank(lo_first, lo_last);
+			size_type below_hi = rank(hi_first, hi_last);
+			return below_hi > below_lo ? below_hi - below_lo : 0;
+		}
+
+	template<typename Container>
+		size_type count_range(const Container &lo, const Container &hi)
+		{
+			return count_range(lo.begin(), lo.end(), hi.begin(), hi.end());
+		}
+
+	// the i-th value in iteration order, end() if there are not that many
+	iterator select(size_type i)
+	{
+		if (i >= root.value_count - root.count())
+			return end();
+		node_ptr cur = &root;
+		for (;;)
+		{
+			if (cur != &root)
+			{
+				if (i < cur->count())
+					return iterator_at(cur, i, boost::integral_constant<bool, multi_value_node>());
+				i -= cur->count();
+			}
+			node_ptr c = cur->children.front();
+			for (; i >= c->value_count; c = cur->children.next(c))
+				i -= c->value_count;
+			cur = c;
+		}
+	}
+
+	// the index of the value at it in iteration order, size() at end()
+	size_type position(const_iterator it) const
+	{
+		node_ptr node = it.tnode;
+		if (node->parent == NULL)
+			return root.value_count - root.count();
+		size_type pos = index_in_node(it, boost::integral_constant<bool, multi_value_node>());
+		for (node_ptr cur = node; cur->parent != NULL; cur = cur->parent)
+		{
+			node_ptr p = cur->parent;
+			if (p != &root)
+				pos += p->count();
+			for (node_ptr c = p->children.front(); c != cur; c = p->children.next(c))
+				pos += c->value_count;
+		}
+		return pos;
+	}
+
+	// the iterator n values after it, or before for negative n; stops at
+	// begin() and end() instead of going past them
+	iterator advance(const_iterator it, std::ptrdiff_t n)
+	{
+		size_type pos = position(it);
+		if (n < 0 && size_type(-n) > pos)
+			return begin();
+		return select(pos + n);
+	}
+
+	// page [offset, offset + limit) of the find_prefix() range, without
+	// walking the values before it
+	template<typename Iter>
+		iterator_range find_prefix(Iter first, Iter last, size_type offset, size_type limit)
+		{
+			node_ptr node = find_node(first, last);
+			if (node == NULL)
+				return std::make_pair(end(), end());
+			iterator start = leftmost_node(node);
+			size_type base = position(start);
+			size_type total = node->value_count - (node == &root ? root.count() : 0);
+			offset = std::min(offset, total);
+			limit = std::min(limit, total - offset);
+			return std::make_pair(select(base + offset), select(base + offset + limit));
+		}
+
+	template<typename Container>
+		iterator_range find_prefix(const Container &container, size_type offset, size_type limit)
+		{
+			return find_prefix(container.begin(), container.end(), offset, limit);
+		}
+
 	// upper_bound() to find the first node that greater than the key
 	template<typename Iter>
 		iterator upper_bound(Iter first, Iter last)
@@ -546,37 +1187,33 @@ public:
 	template<typename Iter>
 		std::pair<iterator, bool> lower_bound(Iter first, Iter last)
 		{
-			typedef typename node_type::children_iter children_iterator;
 			node_ptr cur = &root;
 			node_ptr last_lb_candidate = NULL;
 
 			for (; first != last; ++first)
 			{
 				const key_type& cur_key = *first;
-				children_iterator child_iter =
-					cur->children.find(cur_key, node_comparator);
-				if (child_iter == cur->children.end()) {
+				node_ptr child = cur->children.find(cur_key);
+				if (child == NULL) {
 					break;
 				}
-				children_iterator lb_candidate_iter = child_iter;
-				lb_candidate_iter++;
-				if (lb_candidate_iter != cur->children.end()) {
-					last_lb_candidate = &(*lb_candidate_iter);
+				node_ptr lb_candidate = cur->children.next(child);
+				if (lb_candidate != NULL) {
+					last_lb_candidate = lb_candidate;
 				}
-				cur = &(*child_iter);
+				cur = child;
 			}
 
 			if (first != last) {
-				children_iterator lb_candidate_iter =
-					cur->children.upper_bound(*first, node_comparator);
-				if (lb_candidate_iter == cur->children.end()) {
+				node_ptr lb_candidate = cur->children.upper_bound(*first);
+				if (lb_candidate == NULL) {
 					if (last_lb_candidate != NULL) {
 						cur = last_lb_candidate;
 					} else {
 						return std::make_pair(&root, false);
 					}
 				} else {
-					return std::make_pair(&(*lb_candidate_iter), false);
+					cur = lb_candidate;
 				}
 			}
 
@@ -585,7 +1222,7 @@ public:
 			}
 
 			while (cur->no_value()) {
-				cur = &(*cur->children.begin());
+				cur = cur->children.front();
 			}
 
 			return std::make_pair(cur, false);
@@ -605,11 +1242,12 @@ public:
 			// @that is not right here
 			//return make_pair(lower_bound(first, last), upper_bound(first, last));
 			node_ptr node = find_node(first, last);
-			if (node == NULL || node->value_list_header == NULL)
+			if (node == NULL || node->no_value())
 				return std::make_pair(iterator(&root), iterator(&root));
-			iterator it_end = iterator(node->value_list_tail);
+			// the values of a node are contiguous, the oldest is last
+			iterator it_end = iterator(node, 0);
 			++it_end;
-			return std::make_pair(iterator(node->value_list_header), it_end);
+			return std::make_pair(iterator(node), it_end);
 		}
 
 	template<typename Container>
@@ -623,7 +1261,7 @@ public:
 		while (cur != &root && cur->children.empty() && cur->no_value())
 		{
 			node_ptr parent = cur->parent;
-			parent->children.erase(parent->children.iterator_to(*cur));
+			parent->children.erase(cur, node_allocator);
 			destroy_trie_node(cur);
 			node_count--;
 			cur = parent;
@@ -654,6 +1292,39 @@ public:
 		return ret;
 	}
 
+	// the iterator at the i-th value of node in iteration order
+	static iterator iterator_at(node_ptr node, size_type i, boost::true_type)
+	{
+		return iterator(node, node->newest_index() - i);
+	}
+
+	static iterator iterator_at(node_ptr node, size_type, boost::false_type)
+	{
+		return iterator(node);
+	}
+
+	// how many values of its node come before it in iteration order
+	static size_type index_in_node(const const_iterator& it, boost::true_type)
+	{
+		return it.tnode->newest_index() - it.vindex;
+	}
+
+	static size_type index_in_node(const const_iterator&, boost::false_type)
+	{
+		return 0;
+	}
+
+	// the iterator at the same value as it
+	static iterator mutable_iterator(const const_iterator& it, boost::true_type)
+	{
+		return iterator(it.tnode, it.vindex);
+	}
+
+	static iterator mutable_iterator(const const_iterator& it, boost::false_type)
+	{
+		return iterator(it.tnode);
+	}
+
 	// erase one value, after erasing value, check if it is necessary to erase node
 	iterator erase(iterator it)
 	{
@@ -661,7 +1332,7 @@ public:
 			return it;
 		iterator ret = it;
 		++ret;
-		bool should_erase_node = it.__erase_self_value_node();
+		bool should_erase_node = it.__erase_self_value_node(value_allocator);
 		if (should_erase_node) {
 			erase_node(it.tnode);
 		} else {
@@ -672,7 +1343,7 @@ public:
 
 	iterator erase(const_iterator it)
 	{
-		return erase(iterator(it.tnode, it.vnode));
+		return erase(mutable_iterator(it, boost::integral_constant<bool, multi_value_node>()));
 	}
 
 	template<typename Iter>
@@ -713,6 +1384,8 @@ public:
 		size_type erase_prefix(Iter first, Iter last)
 		{
 			node_ptr cur = find_node(first, last);
+			if (cur == NULL)
+				return 0;
 			size_type ret = cur->value_count;
 			clear(cur);
 			return ret;
@@ -724,40 +1397,30 @@ public:
 			return erase_prefix(container.begin(), container.end());
 		}
 
+	// erase the whole sub-trie rooted at node, node itself included
 	void clear(node_ptr node)
 	{
+		size_type delta = node->value_count;
 		node_ptr cur = node;
-		node_ptr leftmost = leftmost_node(cur);
-		node_ptr rightmost = rightmost_node(cur);
-
-		iterator it(cur);
-
-		if (cur == &root)
-			it = begin();
-
-		if (leftmost == rightmost)
-			return;
-
-		if (leftmost == cur)
+		// post-order walk, always detaching the last child so that the
+		// child containers never have to shift their elements
+		while (true)
 		{
-			cur = (++it).tnode;
-		}
-		else {
-			cur = leftmost;
-		}
-		for (node_ptr next; cur != rightmost; cur = next)
-		{
-			/*
-			 *This is necessary because the ++ operator on the multivalue
-			 *iterator wouldn't always modify tnode and this may result
-			 *in double free
-			 */
-			if (multi_value_node)
-				remove_values_from(it.tnode, value_allocator);
-			next = (++it).tnode;
-			erase_node(cur);
+			while (!cur->children.empty())
+				cur = cur->children.back();
+			if (cur == node)
+				break;
+			node_ptr parent = cur->parent;
+			parent->children.erase(cur, node_allocator);
+			destroy_trie_node(cur);
+			node_count--;
+			cur = parent;
 		}
-		erase_node(cur);
+		if (multi_value_node)
+			remove_values_from(node, value_allocator);
+		else
+			remove_values_from(node);
+		erase_check_ancestor(node, delta);
 	}
 
 	void swap(trie_type& t)
@@ -769,13 +1432,68 @@ public:
 
 	void clear()
 	{
-		clear(&root);
+		if (arena_hooks::sole_owner(node_allocator, allocator_copies))
+			release_arena();
+		else
+			clear(&root);
+	}
+
+	/*
+	 * clear() giving the chunks of an arena_allocator back at once even
+	 * while other copies of the allocator are alive, such as the one the
+	 * trie was built from. Whatever else was allocated from the arena is
+	 * gone too, so nothing else may still use it. With other allocators
+	 * this is clear().
+	 */
+	void release_arena()
+	{
+		if (!arena_hooks::is_arena)
+		{
+			clear(&root);
+			return;
+		}
+		// every node lives in the arena: skip the walk when there is
+		// nothing to destroy, and give the chunks back in one go
+		if (boost::has_trivial_destructor<key_type>::value
+				&& boost::has_trivial_destructor<non_void_value_type>::value)
+		{
+			root.children.release();
+			if (multi_value_node)
+				remove_values_from(&root, value_allocator);
+			else
+				remove_values_from(&root);
+			root.value_count = 0;
+			node_count = 0;
+		} else {
+			clear(&root);
+		}
+		// the recycled blocks are in the chunks too
+		shrink_to_fit();
+		arena_hooks::release(node_allocator);
 	}
 
 	size_type count_node() const {
 		return node_count;
 	}
 
+	// keep up to n erased nodes for reuse
+	void set_free_list_cap(size_type n)
+	{
+		free_nodes.set_cap(n);
+		free_nodes.trim(node_allocator, n);
+	}
+
+	size_type free_list_cap() const
+	{
+		return free_nodes.get_cap();
+	}
+
+	// give the nodes kept for reuse back to the allocator
+	void shrink_to_fit()
+	{
+		free_nodes.trim(node_allocator, 0);
+	}
+
 	size_type size() const {
 		return root.value_count;
 	}
@@ -787,6 +1505,7 @@ public:
 	~trie()
 	{
 		clear();
+		shrink_to_fit();
 	}
 };
 
@@ -10,27 +10,34 @@
 
 namespace boost { namespace tries {
 
-template<typename Key>
+template<typename Key, typename ChildPolicy = adaptive_children_policy,
+	typename Allocator = std::allocator<Key> >
 class trie_multiset
 {
 public:
 	typedef Key key_type;
 	typedef boost::blank value_type;
-	typedef trie<key_type, value_type, true> trie_type;
-	typedef trie_multiset<Key> trie_multiset_type;
+	typedef ChildPolicy child_policy;
+	typedef Allocator allocator_type;
+	typedef trie<key_type, value_type, true, child_policy, allocator_type> trie_type;
+	typedef trie_multiset<Key, child_policy, allocator_type> trie_multiset_type;
 	typedef typename trie_type::const_iterator iterator;
 	typedef typename trie_type::const_iterator const_iterator;
 	typedef typename trie_type::const_reverse_iterator reverse_iterator;
 	typedef typename trie_type::const_reverse_iterator const_reverse_iterator;
 	typedef typename trie_type::pair_iterator_bool pair_iterator_bool;
 	typedef typename trie_type::iterator_range iterator_range;
+	typedef typename trie_type::const_cursor cursor;
+	typedef typename trie_type::const_cursor const_cursor;
+	typedef typename trie_type::const_prefix_cursor prefix_cursor;
+	typedef typename trie_type::const_prefix_cursor const_prefix_cursor;
 	typedef size_t size_type;
 
 protected:
 	trie_type t;
 
 public:
-	explicit trie_multiset() : t()
+	explicit trie_multiset(const allocator_type& alloc = allocator_type()) : t(alloc)
 	{
 	}
 
@@ -44,6 +51,11 @@ public:
 		return *this;
 	}
 
+	allocator_type get_allocator() const
+	{
+		return t.get_allocator();
+	}
+
 	iterator begin() 
 	{
 		return t.cbegin();
@@ -74,6 +86,18 @@ public:
 		return t.cend();
 	}
 
+	// cursor keeping the key as it goes, for cheap full walks
+	const_cursor begin_cursor() const
+	{
+		return t.begin_cursor();
+	}
+
+	// cursor at the empty prefix, for narrowing a prefix element by element
+	const_prefix_cursor begin_prefix_cursor() const
+	{
+		return t.begin_prefix_cursor();
+	}
+
 	reverse_iterator rbegin() 
 	{
 		return t.crbegin();
@@ -116,6 +140,19 @@ public:
 		return t.insert_equal(container, value_type());
 	}
 
+	// insert resuming from the path of hint, like the previous result
+	template<typename Iter>
+	iterator insert(const_iterator hint, Iter first, Iter last)
+	{
+		return t.insert_equal(hint, first, last, value_type());
+	}
+
+	template<typename Container>
+	iterator insert(const_iterator hint, const Container& container)
+	{
+		return t.insert_equal(hint, container, value_type());
+	}
+
 // find() to find the first element that equal
 	template<typename Iter>
 	iterator find(Iter first, Iter last)
@@ -155,6 +192,32 @@ public:
 		return t.count(container);
 	}
 
+	// look up a range of keys at once, see trie::find_batch
+	template<typename KeyIter, typename OutIter>
+	OutIter find_batch(KeyIter first, KeyIter last, OutIter out)
+	{
+		return t.find_batch(first, last, out);
+	}
+
+	template<typename KeyIter, typename OutIter>
+	OutIter count_batch(KeyIter first, KeyIter last, OutIter out)
+	{
+		return t.count_batch(first, last, out);
+	}
+
+	// batch lookups sharing the walk of common prefixes, best on sorted keys
+	template<typename KeyIter, typename OutIter>
+	OutIter find_sorted_batch(KeyIter first, KeyIter last, OutIter out)
+	{
+		return t.find_sorted_batch(first, last, out);
+	}
+
+	template<typename KeyIter, typename OutIter>
+	OutIter count_prefix_sorted_batch(KeyIter first, KeyIter last, OutIter out)
+	{
+		return t.count_prefix_sorted_batch(first, last, out);
+	}
+
 	template<typename Iter>
 	size_type count_prefix(Iter first, Iter last)
 	{
@@ -180,6 +243,62 @@ public:
 		return t.find_prefix(container);
 	}
 
+	// page [offset, offset + limit) of the find_prefix() range
+	template<typename Iter>
+	iterator_range find_prefix(Iter first, Iter last, size_type offset, size_type limit)
+	{
+		return t.find_prefix(first, last, offset, limit);
+	}
+
+	template<typename Container>
+	iterator_range find_prefix(const Container& container, size_type offset, size_type limit)
+	{
+		return t.find_prefix(container, offset, limit);
+	}
+
+	// number of values with a smaller key
+	template<typename Iter>
+	size_type rank(Iter first, Iter last)
+	{
+		return t.rank(first, last);
+	}
+
+	template<typename Container>
+	size_type rank(const Container& container)
+	{
+		return t.rank(container);
+	}
+
+	// number of values with a key in [lo, hi)
+	template<typename Iter>
+	size_type count_range(Iter lo_first, Iter lo_last, Iter hi_first, Iter hi_last)
+	{
+		return t.count_range(lo_first, lo_last, hi_first, hi_last);
+	}
+
+	template<typename Container>
+	size_type count_range(const Container& lo, const Container& hi)
+	{
+		return t.count_range(lo, hi);
+	}
+
+	// the i-th value in order, end() past the last one
+	iterator select(size_type i)
+	{
+		return t.select(i);
+	}
+
+	size_type position(const_iterator it) const
+	{
+		return t.position(it);
+	}
+
+	// n values after it, or before it for negative n
+	iterator advance(const_iterator it, std::ptrdiff_t n)
+	{
+		return t.advance(it, n);
+	}
+
 	// upper and lower bound
 	template<typename Iter>
 	iterator upper_bound(Iter first, Iter last)
@@ -265,6 +384,22 @@ public:
 		return t.count_node();
 	}
 
+	// keep up to n erased nodes for reuse by later insertions
+	void set_free_list_cap(size_type n)
+	{
+		t.set_free_list_cap(n);
+	}
+
+	size_type free_list_cap() const
+	{
+		return t.free_list_cap();
+	}
+
+	void shrink_to_fit()
+	{
+		t.shrink_to_fit();
+	}
+
 // size() to count value in trie
 	size_type size() const
 	{
@@ -286,6 +421,13 @@ public:
 		t.clear();
 	}
 
+	// clear() releasing an arena_allocator's chunks even while the caller
+	// keeps a copy of the allocator; nothing else may use the arena
+	void release_arena()
+	{
+		t.release_arena();
+	}
+
 	~trie_multiset()
 	{
 	}
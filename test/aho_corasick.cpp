@@ -0,0 +1,170 @@
+#include <boost/core/lightweight_test.hpp>
+#include "boost/trie/aho_corasick.hpp"
+// multi include test
+#include "boost/trie/aho_corasick.hpp"
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+typedef boost::tries::trie_set<char> tsci;
+typedef boost::tries::trie_map<char, int> tmci;
+typedef boost::tries::aho_corasick_matcher<char> acm;
+
+// (position, length, pattern) of every match, in reporting order
+struct collector {
+	std::vector<acm::match_type> *out;
+
+	explicit collector(std::vector<acm::match_type> *out) : out(out)
+	{
+	}
+
+	void operator()(const acm::match_type& m)
+	{
+		out->push_back(m);
+	}
+};
+
+bool match_less(const acm::match_type& a, const acm::match_type& b)
+{
+	if (a.position + a.length != b.position + b.length)
+		return a.position + a.length < b.position + b.length;
+	return a.length > b.length;
+}
+
+bool match_equal(const acm::match_type& a, const acm::match_type& b)
+{
+	return a.position == b.position && a.length == b.length && a.pattern == b.pattern;
+}
+
+// every occurrence of every word, ordered by end and then longest first
+std::vector<acm::match_type> brute_force(const std::vector<std::string>& words,
+		const std::string& text)
+{
+	std::vector<acm::match_type> res;
+	for (size_t w = 0; w < words.size(); ++w)
+		for (size_t p = 0; p + words[w].size() <= text.size(); ++p)
+			if (text.compare(p, words[w].size(), words[w]) == 0)
+			{
+				acm::match_type m = { p, words[w].size(), w };
+				res.push_back(m);
+			}
+	std::sort(res.begin(), res.end(), match_less);
+	return res;
+}
+
+bool same_matches(const std::vector<acm::match_type>& a, const std::vector<acm::match_type>& b)
+{
+	return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), match_equal);
+}
+
+void small_test()
+{
+	tsci t;
+	std::string words[] = { "he", "she", "his", "hers" };
+	for (int i = 0; i < 4; ++i)
+		t.insert(words[i]);
+	acm m = boost::tries::build_matcher(t);
+	BOOST_TEST(m.size() == 4);
+	BOOST_TEST(m.count_node() == t.count_node());
+
+	std::vector<acm::match_type> found;
+	m.scan(std::string("ushers"), collector(&found));
+	// keys are ranked in trie order: he, hers, his, she
+	BOOST_TEST(found.size() == 3);
+	BOOST_TEST(found[0].position == 1 && found[0].length == 3 && found[0].pattern == 3);
+	BOOST_TEST(found[1].position == 2 && found[1].length == 2 && found[1].pattern == 0);
+	BOOST_TEST(found[2].position == 2 && found[2].length == 4 && found[2].pattern == 1);
+
+	found.clear();
+	m.scan(std::string("xyz"), collector(&found));
+	BOOST_TEST(found.empty());
+
+	acm e;
+	BOOST_TEST(e.empty());
+	e.scan(std::string("abc"), collector(&found));
+	BOOST_TEST(found.empty());
+}
+
+void map_test()
+{
+	tmci t;
+	t[std::string("a")] = 1;
+	t[std::string("aa")] = 2;
+	t[std::string("ab")] = 3;
+	acm m(t);
+	BOOST_TEST(m.size() == 3);
+	std::vector<acm::match_type> found;
+	m.scan(std::string("aab"), collector(&found));
+	BOOST_TEST(found.size() == 4);
+	// a, then aa and a, then ab
+	BOOST_TEST(found[0].position == 0 && found[0].pattern == 0);
+	BOOST_TEST(found[1].position == 0 && found[1].length == 2 && found[1].pattern == 1);
+	BOOST_TEST(found[2].position == 1 && found[2].length == 1);
+	BOOST_TEST(found[3].position == 1 && found[3].length == 2 && found[3].pattern == 2);
+}
+
+void stream_test()
+{
+	tsci t;
+	std::string words[] = { "abc", "bcd", "c", "abcdx" };
+	for (int i = 0; i < 4; ++i)
+		t.insert(words[i]);
+	acm m(t);
+	std::string text = "zabcdxabcabcd";
+	std::vector<acm::match_type> whole, pieces;
+	m.scan(text, collector(&whole));
+	// every split of the text into three buffers reports the same
+	for (size_t i = 0; i <= text.size(); ++i)
+		for (size_t j = i; j <= text.size(); ++j)
+		{
+			pieces.clear();
+			acm::scan_state state;
+			m.scan(text.begin(), text.begin() + i, collector(&pieces), state);
+			m.scan(text.begin() + i, text.begin() + j, collector(&pieces), state);
+			m.scan(text.begin() + j, text.end(), collector(&pieces), state);
+			BOOST_TEST(same_matches(whole, pieces));
+			BOOST_TEST(state.offset == text.size());
+		}
+}
+
+void random_test()
+{
+	for (int round = 0; round < 20; ++round)
+	{
+		tsci t;
+		int n = rand() % 30 + 1;
+		for (int i = 0; i < n; ++i)
+		{
+			std::string w;
+			int len = rand() % 5 + 1;
+			for (int j = 0; j < len; ++j)
+				w += static_cast<char>('a' + rand() % 3);
+			t.insert(w);
+		}
+		std::vector<std::string> words;
+		for (tsci::iterator it = t.begin(); it != t.end(); ++it)
+		{
+			std::vector<char> k = *it;
+			words.push_back(std::string(k.begin(), k.end()));
+		}
+		std::string text;
+		for (int i = 0; i < 200; ++i)
+			text += static_cast<char>('a' + rand() % 3);
+
+		acm m(t);
+		std::vector<acm::match_type> found;
+		m.scan(text, collector(&found));
+		BOOST_TEST(same_matches(found, brute_force(words, text)));
+	}
+}
+
+int main()
+{
+	small_test();
+	map_test();
+	stream_test();
+	random_test();
+	return boost::report_errors();
+}
@@ -0,0 +1,323 @@
+#include <boost/core/lightweight_test.hpp>
+#include "boost/trie/trie_map.hpp"
+#include "boost/trie/trie_set.hpp"
+#include "boost/trie/trie_multimap.hpp"
+#include "boost/trie/trie_multiset.hpp"
+#include "boost/trie/arena_allocator.hpp"
+
+#include <string>
+#include <vector>
+#include <memory>
+
+struct allocation_stats {
+	long live;
+	long total;
+
+	allocation_stats() : live(0), total(0)
+	{
+	}
+};
+
+// stateful allocator counting the blocks it hands out
+template <typename T>
+struct counting_allocator {
+	typedef T value_type;
+	typedef T* pointer;
+	typedef const T* const_pointer;
+	typedef T& reference;
+	typedef const T& const_reference;
+	typedef std::size_t size_type;
+	typedef std::ptrdiff_t difference_type;
+
+	template <typename U>
+	struct rebind {
+		typedef counting_allocator<U> other;
+	};
+
+	allocation_stats *stats;
+
+	explicit counting_allocator(allocation_stats *s) : stats(s)
+	{
+	}
+
+	template <typename U>
+	counting_allocator(const counting_allocator<U>& other) : stats(other.stats)
+	{
+	}
+
+	pointer allocate(size_type n)
+	{
+		++stats->live;
+		++stats->total;
+		return std::allocator<T>().allocate(n);
+	}
+
+	void deallocate(pointer p, size_type n)
+	{
+		--stats->live;
+		std::allocator<T>().deallocate(p, n);
+	}
+
+	bool operator==(const counting_allocator& other) const
+	{
+		return stats == other.stats;
+	}
+
+	bool operator!=(const counting_allocator& other) const
+	{
+		return stats != other.stats;
+	}
+};
+
+void map_test()
+{
+	allocation_stats stats;
+	{
+		typedef boost::tries::trie_map<char, int, boost::tries::adaptive_children_policy,
+			counting_allocator<int> > counted_map;
+		counted_map t((counting_allocator<int>(&stats)));
+		BOOST_TEST(t.get_allocator().stats == &stats);
+		for (int i = 0; i < 300; ++i)
+		{
+			std::string k(1, static_cast<char>(i % 256));
+			k += "suffix";
+			t[k] = i;
+		}
+		// every node and every child block came from the allocator
+		BOOST_TEST(stats.live >= long(t.count_node()));
+		counted_map t2(t);
+		BOOST_TEST(t2.get_allocator() == t.get_allocator());
+		t.erase_prefix(std::string("a"));
+		t.clear();
+		BOOST_TEST(stats.live > 0);
+	}
+	BOOST_TEST(stats.live == 0);
+	BOOST_TEST(stats.total > 0);
+}
+
+void set_test()
+{
+	allocation_stats stats;
+	{
+		boost::tries::trie_set<char, boost::tries::rbtree_children_policy,
+			counting_allocator<char> > t((counting_allocator<char>(&stats)));
+		t.insert(std::string("abc"));
+		t.insert(std::string("abd"));
+		BOOST_TEST(stats.live == 4);
+		t.erase(std::string("abd"));
+		BOOST_TEST(stats.live == 3);
+	}
+	BOOST_TEST(stats.live == 0);
+}
+
+void multi_test()
+{
+	allocation_stats stats;
+	{
+		boost::tries::trie_multimap<char, int, boost::tries::adaptive_children_policy,
+			counting_allocator<int> > t((counting_allocator<int>(&stats)));
+		std::string s = "aa";
+		t.insert(s, 1);
+		t.insert(s, 2);
+		t.insert(s, 3);
+		// the values fit in the node
+		BOOST_TEST(stats.live == 2);
+		for (int i = 4; i <= 8; ++i)
+			t.insert(s, i);
+		// and then spill to one array
+		BOOST_TEST(stats.live == 3);
+		BOOST_TEST((*t.begin()).second == 8);
+		for (int i = 0; i < 5; ++i)
+			t.erase(t.begin());
+		BOOST_TEST(stats.live == 2);
+		BOOST_TEST(t.count(s) == 3);
+		BOOST_TEST((*t.begin()).second == 3);
+
+		boost::tries::trie_multiset<char, boost::tries::vector_children_policy,
+			counting_allocator<char> > ms((counting_allocator<char>(&stats)));
+		ms.insert(s);
+		ms.insert(s);
+		BOOST_TEST(ms.count(s) == 2);
+		ms.clear();
+	}
+	BOOST_TEST(stats.live == 0);
+}
+
+void free_list_test()
+{
+	allocation_stats stats;
+	{
+		typedef boost::tries::trie_map<char, int, boost::tries::adaptive_children_policy,
+			counting_allocator<int> > counted_map;
+		counted_map t((counting_allocator<int>(&stats)));
+		BOOST_TEST(t.free_list_cap() == 0);
+		t.set_free_list_cap(16);
+		t[std::string("sess")] = 0;
+		std::string k = "sess0000";
+		for (int i = 0; i < 1000; ++i)
+		{
+			if (i == 1)
+				stats.total = 0;
+			for (int j = 4; j < 8; ++j)
+				k[j] = static_cast<char>('a' + (i >> (j * 2 - 8)) % 26);
+			t[k] = i;
+			BOOST_TEST(t.size() == 2);
+			t.erase(k);
+		}
+		// after the first round every node comes from the free list
+		BOOST_TEST(stats.total == 0);
+		long live = stats.live;
+		t.shrink_to_fit();
+		BOOST_TEST(stats.live == live - 4);
+
+		boost::tries::trie_multimap<char, int, boost::tries::adaptive_children_policy,
+			counting_allocator<int> > mm((counting_allocator<int>(&stats)));
+		mm.set_free_list_cap(2);
+		mm.insert(k, 1);
+		for (int i = 0; i < 100; ++i)
+		{
+			if (i == 1)
+				stats.total = 0;
+			mm.insert(k, i);
+			mm.erase(mm.begin());
+		}
+		BOOST_TEST(stats.total == 0);
+		BOOST_TEST(mm.count(k) == 1);
+		mm.clear();
+		// only two of the eight nodes are kept
+		live = stats.live;
+		mm.set_free_list_cap(0);
+		BOOST_TEST(stats.live == live - 2);
+	}
+	BOOST_TEST(stats.live == 0);
+}
+
+void arena_test()
+{
+	typedef boost::tries::arena_allocator<int> arena_type;
+	typedef boost::tries::trie_map<char, int, boost::tries::adaptive_children_policy,
+		arena_type> arena_map;
+	// the trie holds the only copies of its allocator
+	arena_map t((arena_type(4096)));
+	for (int i = 0; i < 2000; ++i)
+	{
+		std::string k(1 + i % 7, static_cast<char>('a' + i % 26));
+		k += static_cast<char>(i % 256);
+		t[k] = i;
+	}
+	size_t n = t.size();
+	BOOST_TEST(t.get_allocator().chunk_count() > 1);
+	BOOST_TEST(t.get_allocator().bytes_used() >= t.count_node() * sizeof(int));
+
+	// the copy gets an arena of its own
+	arena_map t2(t);
+	BOOST_TEST(t2.get_allocator() != t.get_allocator());
+	BOOST_TEST(t2.size() == n);
+
+	// erasing single keys does not give memory back
+	size_t chunks = t.get_allocator().chunk_count();
+	t.erase(t.begin());
+	BOOST_TEST(t.get_allocator().chunk_count() == chunks);
+
+	t.clear();
+	BOOST_TEST(t.get_allocator().chunk_count() == 0);
+	BOOST_TEST(t.empty());
+	BOOST_TEST(t.count_node() == 0);
+	BOOST_TEST(t.begin() == t.end());
+	t[std::string("again")] = 1;
+	BOOST_TEST(t.size() == 1);
+	BOOST_TEST(t[std::string("again")] == 1);
+	BOOST_TEST(t.get_allocator().chunk_count() == 1);
+
+	t2.clear();
+	BOOST_TEST(t2.empty());
+
+	// two tries in one arena: clearing one must not release the other
+	{
+		typedef boost::tries::trie_multimap<char, int, boost::tries::vector_children_policy,
+			arena_type> arena_multimap;
+		arena_type shared;
+		arena_multimap a(shared), b(shared);
+		std::string k = "key";
+		a.insert(k, 1);
+		a.insert(k, 2);
+		b.insert(k, 3);
+		a.clear();
+		BOOST_TEST(shared.chunk_count() == 1);
+		BOOST_TEST(b.count(k) == 1);
+		BOOST_TEST((*b.begin()).second == 3);
+	}
+
+	// memory of another container in the arena outlives clear() and the trie
+	{
+		arena_type alloc(4096);
+		std::vector<int, arena_type> v(alloc);
+		{
+			arena_map a(alloc);
+			for (int i = 0; i < 100; ++i)
+				v.push_back(i);
+			a[std::string("abc")] = 1;
+			a.clear();
+			BOOST_TEST(alloc.chunk_count() != 0);
+			BOOST_TEST(v[99] == 99);
+			a[std::string("abd")] = 2;
+		}
+		BOOST_TEST(alloc.chunk_count() != 0);
+		v.push_back(100);
+		BOOST_TEST(v[50] == 50 && v[100] == 100);
+	}
+
+	// release_arena() drops the chunks while the caller keeps the allocator
+	{
+		arena_type alloc(4096);
+		arena_map a(alloc);
+		for (int i = 0; i < 500; ++i)
+			a[std::string(1 + i % 9, static_cast<char>('a' + i % 26))] = i;
+		a.clear();
+		BOOST_TEST(alloc.chunk_count() != 0);
+		a[std::string("abc")] = 1;
+		a.release_arena();
+		BOOST_TEST(alloc.chunk_count() == 0);
+		BOOST_TEST(a.empty());
+		BOOST_TEST(a.count_node() == 0);
+		a[std::string("abd")] = 2;
+		BOOST_TEST(a.size() == 1);
+		BOOST_TEST(alloc.chunk_count() == 1);
+
+		// with another allocator it is clear()
+		boost::tries::trie_multimap<char, int> m;
+		m.insert(std::string("key"), 1);
+		m.insert(std::string("key"), 2);
+		m.release_arena();
+		BOOST_TEST(m.empty());
+		BOOST_TEST(m.count_node() == 0);
+	}
+
+	// keys with a destructor are walked before the chunks go
+	{
+		typedef boost::tries::trie_set<std::string, boost::tries::rbtree_children_policy,
+			boost::tries::arena_allocator<std::string> > string_set;
+		string_set s;
+		std::vector<std::string> key;
+		key.push_back("a long enough string to live on the heap");
+		key.push_back("b");
+		s.insert(key);
+		key.pop_back();
+		key.push_back("c");
+		s.insert(key);
+		BOOST_TEST(s.size() == 2);
+		s.clear();
+		BOOST_TEST(s.get_allocator().chunk_count() == 0);
+		s.insert(key);
+		BOOST_TEST(s.size() == 1);
+	}
+}
+
+int main() {
+	map_test();
+	set_test();
+	multi_test();
+	free_list_test();
+	arena_test();
+	return boost::report_errors();
+}
@@ -0,0 +1,13 @@
+#include "boost/trie/trie_map.hpp"
+
+#include <vector>
+
+// byte_key_index would put 1 and 257 in the same slot, so the default
+// indexed_children_policy must refuse int keys
+int main()
+{
+	boost::tries::trie_map<int, int, boost::tries::indexed_children_policy<> > t;
+	std::vector<int> k(1, 257);
+	t[k] = 20;
+	return 0;
+}
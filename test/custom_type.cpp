@@ -261,6 +261,37 @@ void erase_key()
 	BOOST_TEST((*ti).second == 0);
 }
 
+template <typename ChildPolicy>
+void child_policy_test()
+{
+	typedef boost::tries::trie_map<mytype, mytype, ChildPolicy> policy_map;
+	policy_map t;
+	t[s] = 1;
+	t[s1] = 2;
+	t[s2] = 3;
+	t[s3] = 4;
+	t[s4] = 5;
+	BOOST_TEST(t.size() == 5);
+	BOOST_TEST(t.count_prefix(s) == 3);
+	BOOST_TEST(t.count_prefix(s5) == 2);
+	typename policy_map::iterator ti = t.begin();
+	BOOST_TEST((*ti).second == 1);
+	++ti;
+	BOOST_TEST((*ti).second == 3);
+	++ti;
+	BOOST_TEST((*ti).second == 2);
+	++ti;
+	BOOST_TEST((*ti).second == 5);
+	++ti;
+	BOOST_TEST((*ti).second == 4);
+	++ti;
+	BOOST_TEST(ti == t.end());
+	t.erase(s2);
+	BOOST_TEST(t.lower_bound(s2) == t.find(s1));
+	t.clear();
+	BOOST_TEST(t.count_node() == 0);
+}
+
 int main() {
 	operator_test();
 	insert_and_find_test();
@@ -270,4 +301,7 @@ int main() {
 	clear();
 	erase_iterator();
 	erase_key();
+	child_policy_test<boost::tries::rbtree_children_policy>();
+	child_policy_test<boost::tries::vector_children_policy>();
+	return boost::report_errors();
 }
@@ -0,0 +1,149 @@
+#include <boost/core/lightweight_test.hpp>
+#include "boost/trie/frozen_trie_map.hpp"
+#include "boost/trie/frozen_trie_set.hpp"
+// multi include test
+#include "boost/trie/frozen_trie_map.hpp"
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <map>
+
+typedef boost::tries::trie_map<char, int> tmci;
+typedef boost::tries::frozen_trie_map<char, int> fmci;
+
+std::string key_string(fmci::const_iterator it)
+{
+	std::vector<char> k = it.get_key();
+	return std::string(k.begin(), k.end());
+}
+
+void empty_test()
+{
+	tmci t;
+	fmci f(t);
+	BOOST_TEST(f.empty());
+	BOOST_TEST(f.begin() == f.end());
+	BOOST_TEST(f.find(std::string("a")) == f.end());
+	BOOST_TEST(f.count_prefix(std::string("")) == 0);
+	BOOST_TEST(f.lower_bound(std::string("a")) == f.end());
+}
+
+void map_test()
+{
+	tmci t;
+	std::string words[] = { "to", "tea", "ted", "ten", "i", "in", "inn", "a" };
+	for (int i = 0; i < 8; ++i)
+		t[words[i]] = i;
+	fmci f(t);
+	BOOST_TEST(f.size() == 8);
+	BOOST_TEST(f.count_node() == t.count_node());
+	for (int i = 0; i < 8; ++i)
+	{
+		BOOST_TEST(f.count(words[i]) == 1);
+		BOOST_TEST((*f.find(words[i])).second == i);
+		BOOST_TEST(key_string(f.find(words[i])) == words[i]);
+	}
+	BOOST_TEST(f.find(std::string("te")) == f.end());
+	BOOST_TEST(f.count(std::string("te")) == 0);
+	BOOST_TEST(f.find(std::string("tex")) == f.end());
+	BOOST_TEST(f.count_prefix(std::string("te")) == 3);
+	BOOST_TEST(f.count_prefix(std::string("t")) == 4);
+	BOOST_TEST(f.count_prefix(std::string("in")) == 2);
+	BOOST_TEST(f.count_prefix(std::string("x")) == 0);
+
+	fmci::iterator_range r = f.find_prefix(std::string("te"));
+	BOOST_TEST(key_string(r.first) == "tea");
+	BOOST_TEST(r.second == f.find(std::string("to")));
+	int n = 0;
+	for (; r.first != r.second; ++r.first)
+		++n;
+	BOOST_TEST(n == 3);
+
+	tmci::iterator ti = t.begin();
+	for (fmci::const_iterator fi = f.begin(); fi != f.end(); ++fi, ++ti)
+	{
+		BOOST_TEST(fi.get_key() == ti.get_key());
+		BOOST_TEST((*fi).second == (*ti).second);
+	}
+	BOOST_TEST(ti == t.end());
+	BOOST_TEST((*f.rbegin()).second == 0);
+
+	BOOST_TEST(f.lower_bound(std::string("te")) == f.find(std::string("tea")));
+	BOOST_TEST(f.lower_bound(std::string("tee")) == f.find(std::string("ten")));
+	BOOST_TEST(f.lower_bound(std::string("tez")) == f.find(std::string("to")));
+	BOOST_TEST(f.lower_bound(std::string("z")) == f.end());
+	BOOST_TEST(f.upper_bound(std::string("ted")) == f.find(std::string("ten")));
+	BOOST_TEST(f.upper_bound(std::string("to")) == f.end());
+
+	// the frozen copy does not depend on the source
+	t.clear();
+	BOOST_TEST((*f.find(std::string("inn"))).second == 6);
+}
+
+// signed keys over every byte value, checked against std::map (vector
+// keys, as std::string compares its chars unsigned)
+void random_test()
+{
+	tmci t;
+	std::map<std::vector<char>, int> m;
+	std::srand(4321);
+	for (int i = 0; i < 3000; ++i)
+	{
+		std::vector<char> k(1 + std::rand() % 6);
+		for (size_t j = 0; j < k.size(); ++j)
+			k[j] = static_cast<char>(j == 0 ? std::rand() % 256 : std::rand() % 4 - 2);
+		t[k] = i;
+		m[k] = i;
+	}
+	fmci f(t);
+	BOOST_TEST(f.size() == m.size());
+	fmci::const_iterator fi = f.begin();
+	for (std::map<std::vector<char>, int>::iterator mi = m.begin(); mi != m.end(); ++mi, ++fi)
+	{
+		BOOST_TEST(fi.get_key() == mi->first);
+		BOOST_TEST((*fi).second == mi->second);
+	}
+	for (int i = 0; i < 1000; ++i)
+	{
+		std::vector<char> k(std::rand() % 4);
+		for (size_t j = 0; j < k.size(); ++j)
+			k[j] = static_cast<char>(j == 0 ? std::rand() % 256 : std::rand() % 4 - 2);
+		BOOST_TEST(f.count(k) == m.count(k));
+		BOOST_TEST(f.count_prefix(k) == t.count_prefix(k));
+		std::map<std::vector<char>, int>::iterator mi = m.lower_bound(k);
+		fi = f.lower_bound(k);
+		BOOST_TEST(mi == m.end() ? fi == f.end() : fi.get_key() == mi->first);
+		mi = m.upper_bound(k);
+		fi = f.upper_bound(k);
+		BOOST_TEST(mi == m.end() ? fi == f.end() : fi.get_key() == mi->first);
+	}
+}
+
+void set_test()
+{
+	boost::tries::trie_set<unsigned char> t;
+	std::vector<unsigned char> k1(3, 255), k2(2, 0), k3;
+	k3.push_back(0);
+	k3.push_back(255);
+	t.insert(k1);
+	t.insert(k2);
+	t.insert(k3);
+	boost::tries::frozen_trie_set<unsigned char> f(t);
+	BOOST_TEST(f.size() == 3);
+	BOOST_TEST(f.count(k1) == 1);
+	BOOST_TEST(f.count(std::vector<unsigned char>(2, 255)) == 0);
+	BOOST_TEST(*f.begin() == k2);
+	BOOST_TEST(*f.find(k3) == k3);
+	BOOST_TEST(f.count_prefix(std::vector<unsigned char>(1, 0)) == 2);
+	f.clear();
+	BOOST_TEST(f.empty());
+}
+
+int main() {
+	empty_test();
+	map_test();
+	random_test();
+	set_test();
+	return boost::report_errors();
+}
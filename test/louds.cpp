@@ -0,0 +1,112 @@
+#include <boost/core/lightweight_test.hpp>
+#include "boost/trie/louds_trie_set.hpp"
+// multi include test
+#include "boost/trie/louds_trie_set.hpp"
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <set>
+#include <iterator>
+
+typedef boost::tries::trie_set<char> tsci;
+typedef boost::tries::louds_trie_set<char> lsci;
+
+void small_test()
+{
+	tsci t;
+	std::string words[] = { "to", "tea", "ted", "ten", "i", "in", "inn", "a" };
+	for (int i = 0; i < 8; ++i)
+		t.insert(words[i]);
+	lsci l(t);
+	BOOST_TEST(l.size() == 8);
+	BOOST_TEST(l.count_node() == t.count_node());
+	for (int i = 0; i < 8; ++i)
+		BOOST_TEST(l.count(words[i]) == 1);
+	BOOST_TEST(l.count(std::string("te")) == 0);
+	BOOST_TEST(l.count(std::string("tex")) == 0);
+	BOOST_TEST(l.find_node(std::string("te")) != lsci::npos);
+	BOOST_TEST(l.find_node(std::string("x")) == lsci::npos);
+	BOOST_TEST(l.count_prefix(std::string("")) == 8);
+	BOOST_TEST(l.count_prefix(std::string("t")) == 4);
+	BOOST_TEST(l.count_prefix(std::string("te")) == 3);
+	BOOST_TEST(l.count_prefix(std::string("inn")) == 1);
+	BOOST_TEST(l.count_prefix(std::string("x")) == 0);
+
+	std::vector<std::vector<char> > found;
+	l.find_prefix(std::string("i"), std::back_inserter(found));
+	BOOST_TEST(found.size() == 3);
+	BOOST_TEST(std::string(found[0].begin(), found[0].end()) == "i");
+	BOOST_TEST(std::string(found[2].begin(), found[2].end()) == "inn");
+	found.clear();
+	l.find_prefix(std::string(""), std::back_inserter(found));
+	std::vector<std::vector<char> > all;
+	for (tsci::iterator it = t.begin(); it != t.end(); ++it)
+		all.push_back(*it);
+	BOOST_TEST(found == all);
+}
+
+void sorted_input_test()
+{
+	std::vector<std::string> words;
+	words.push_back("abc");
+	words.push_back("abc");
+	words.push_back("abd");
+	words.push_back("b");
+	lsci l(words.begin(), words.end());
+	BOOST_TEST(l.size() == 3);
+	BOOST_TEST(l.count_node() == 5);
+	BOOST_TEST(l.count(std::string("abd")) == 1);
+	BOOST_TEST(l.count_prefix(std::string("ab")) == 2);
+
+	lsci e;
+	BOOST_TEST(e.empty());
+	BOOST_TEST(e.count(std::string("a")) == 0);
+	BOOST_TEST(e.count_prefix(std::string("")) == 0);
+}
+
+// enough nodes for several rank blocks, checked against std::set
+void random_test()
+{
+	std::set<std::string> s;
+	tsci t;
+	std::srand(777);
+	for (int i = 0; i < 5000; ++i)
+	{
+		std::string k(1 + std::rand() % 8, 'a');
+		for (size_t j = 0; j < k.size(); ++j)
+			k[j] = 'a' + std::rand() % 5;
+		s.insert(k);
+		t.insert(k);
+	}
+	lsci l(t);
+	BOOST_TEST(l.size() == s.size());
+	BOOST_TEST(l.count_node() == t.count_node());
+	// a few bits per node plus the one byte label
+	BOOST_TEST(l.memory_size() < l.count_node() * 2);
+	for (int i = 0; i < 2000; ++i)
+	{
+		std::string k(std::rand() % 6, 'a');
+		for (size_t j = 0; j < k.size(); ++j)
+			k[j] = 'a' + std::rand() % 6;
+		BOOST_TEST(l.count(k) == s.count(k));
+		BOOST_TEST(l.count_prefix(k) == t.count_prefix(k));
+		if (i % 50 == 0)
+		{
+			std::vector<std::vector<char> > found;
+			l.find_prefix(k, std::back_inserter(found));
+			std::vector<std::vector<char> >::iterator fi = found.begin();
+			tsci::iterator_range r = t.find_prefix(k);
+			for (; r.first != r.second && fi != found.end(); ++r.first, ++fi)
+				BOOST_TEST(*r.first == *fi);
+			BOOST_TEST(r.first == r.second && fi == found.end());
+		}
+	}
+}
+
+int main() {
+	small_test();
+	sorted_input_test();
+	random_test();
+	return boost::report_errors();
+}
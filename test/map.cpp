@@ -5,6 +5,12 @@
 #include "boost/trie/trie.hpp"
 
 #include <string>
+#include <vector>
+#include <map>
+#include <iterator>
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
 
 
 typedef boost::tries::trie_map<char, int> tmci;
@@ -300,6 +306,9 @@ void erase_iterator()
 	BOOST_TEST(t.size() == 3);
 	BOOST_TEST((*i).second == 0);
 	BOOST_TEST(t.count_node() == 7);
+	tci ci = t.begin();
+	t.erase(ci);
+	BOOST_TEST(t.size() == 2);
 }
 
 void erase_key()
@@ -435,6 +444,547 @@ void get_key_reverse_test()
 	}
 }
 
+void wide_fanout_test()
+{
+	// walk a node through all its child container layouts and back
+	tmci t;
+	std::map<std::vector<char>, int> m;
+	for (int i = 0; i < 256; ++i)
+	{
+		char c = static_cast<char>((i * 37) % 256);
+		std::vector<char> k(1, c);
+		t[k] = i;
+		m[k] = i;
+		k.push_back('x');
+		t[k] = -i;
+		m[k] = -i;
+		BOOST_TEST(t.size() == m.size());
+	}
+	BOOST_TEST(t.count_node() == 512);
+	tmci::iterator ti = t.begin();
+	std::map<std::vector<char>, int>::iterator mi = m.begin();
+	for (; mi != m.end(); ++mi, ++ti)
+	{
+		BOOST_TEST(ti.get_key() == mi->first);
+		BOOST_TEST((*ti).second == mi->second);
+	}
+	BOOST_TEST(ti == t.end());
+	std::map<std::vector<char>, int>::reverse_iterator rmi = m.rbegin();
+	for (tmci::reverse_iterator rti = t.rbegin(); rti != t.rend(); ++rti, ++rmi)
+	{
+		BOOST_TEST((*rti).first == rmi->first);
+	}
+	BOOST_TEST(rmi == m.rend());
+	for (int i = 0; i < 256; ++i)
+	{
+		char c = static_cast<char>((i * 101) % 256);
+		std::vector<char> k(1, c);
+		if (i % 4 != 0)
+		{
+			t.erase_prefix(k);
+			m.erase(k);
+			k.push_back('x');
+			m.erase(k);
+		}
+		BOOST_TEST(t.size() == m.size());
+	}
+	for (mi = m.begin(), ti = t.begin(); mi != m.end(); ++mi, ++ti)
+	{
+		BOOST_TEST(ti.get_key() == mi->first);
+		BOOST_TEST(t.find(mi->first) != t.end());
+		BOOST_TEST(t.lower_bound(mi->first) == t.find(mi->first));
+	}
+	BOOST_TEST(ti == t.end());
+	t.clear();
+	BOOST_TEST(t.empty());
+	BOOST_TEST(t.count_node() == 0);
+}
+
+// ordered queries on nodes of every fanout, against std::map
+void fanout_bound_test()
+{
+	const int fanouts[] = { 3, 4, 10, 16, 17, 30, 48, 49, 90, 200, 256 };
+	for (size_t f = 0; f < sizeof(fanouts) / sizeof(fanouts[0]); ++f)
+	{
+		tmci t;
+		std::map<std::vector<char>, int> m;
+		for (int i = 0; i < fanouts[f]; ++i)
+		{
+			std::vector<char> k(1, static_cast<char>((i * 37) % 256));
+			t[k] = i;
+			m[k] = i;
+		}
+		for (int b = 0; b < 256; ++b)
+		{
+			std::vector<char> k(1, static_cast<char>(b));
+			std::map<std::vector<char>, int>::iterator mi = m.lower_bound(k);
+			tmci::iterator ti = t.lower_bound(k);
+			BOOST_TEST(mi == m.end() ? ti == t.end() : ti.get_key() == mi->first);
+			mi = m.upper_bound(k);
+			ti = t.upper_bound(k);
+			BOOST_TEST(mi == m.end() ? ti == t.end() : ti.get_key() == mi->first);
+			BOOST_TEST((t.find(k) != t.end()) == (m.count(k) == 1));
+		}
+		std::map<std::vector<char>, int>::reverse_iterator rmi = m.rbegin();
+		for (tmci::reverse_iterator rti = t.rbegin(); rti != t.rend(); ++rti, ++rmi)
+			BOOST_TEST((*rti).first == rmi->first);
+		BOOST_TEST(rmi == m.rend());
+	}
+}
+
+template <typename ChildPolicy>
+void child_policy_test()
+{
+	typedef boost::tries::trie_map<char, int, ChildPolicy> policy_map;
+	policy_map t;
+	std::map<std::vector<char>, int> m;
+	for (int i = 0; i < 300; ++i)
+	{
+		std::vector<char> k;
+		k.push_back(static_cast<char>((i * 53) % 256));
+		k.push_back(static_cast<char>(i % 7));
+		if (i % 3 == 0)
+			k.push_back('z');
+		t[k] = i;
+		m[k] = i;
+	}
+	BOOST_TEST(t.size() == m.size());
+	typename policy_map::iterator ti = t.begin();
+	std::map<std::vector<char>, int>::iterator mi = m.begin();
+	for (; mi != m.end(); ++mi, ++ti)
+	{
+		BOOST_TEST(ti.get_key() == mi->first);
+		BOOST_TEST((*ti).second == mi->second);
+	}
+	BOOST_TEST(ti == t.end());
+	policy_map t2(t);
+	BOOST_TEST(t2.size() == t.size());
+	BOOST_TEST(t2.count_node() == t.count_node());
+	for (mi = m.begin(); mi != m.end(); ++mi)
+	{
+		BOOST_TEST(t.lower_bound(mi->first) == t.find(mi->first));
+		if (mi->second % 2)
+			t.erase(mi->first);
+	}
+	ti = t.end();
+	for (std::map<std::vector<char>, int>::reverse_iterator rmi = m.rbegin();
+		rmi != m.rend(); ++rmi)
+	{
+		if (rmi->second % 2 == 0)
+		{
+			--ti;
+			BOOST_TEST((*ti).second == rmi->second);
+		}
+	}
+	BOOST_TEST(ti == t.begin());
+	t.clear();
+	BOOST_TEST(t.count_node() == 0);
+	BOOST_TEST(t2.find(m.begin()->first) != t2.end());
+}
+
+// int keys need a KeyIndex of their own, byte_key_index only takes bytes
+struct small_int_index {
+	static const std::size_t size = 512;
+
+	std::size_t operator () (int key) const
+	{
+		return key >= 0 && key < 512 ? std::size_t(key) : size;
+	}
+};
+
+void indexed_int_key_test()
+{
+	typedef boost::tries::trie_map<int, int,
+		boost::tries::indexed_children_policy<small_int_index> > int_map;
+	int_map t;
+	std::vector<int> k1(1, 1), k2(1, 257);
+	t[k1] = 10;
+	t[k2] = 20;
+	BOOST_TEST(t.size() == 2);
+	BOOST_TEST(t[k1] == 10);
+	BOOST_TEST(t[k2] == 20);
+
+	// an element without a slot is refused before any node is made
+	std::vector<int> bad = k1;
+	bad.push_back(3);
+	bad.push_back(600);
+	size_t nodes = t.count_node();
+	BOOST_TEST_THROWS(t.insert(bad, 30), std::out_of_range);
+	BOOST_TEST_THROWS(t.insert(t.begin(), bad, 30), std::out_of_range);
+	BOOST_TEST(t.size() == 2);
+	BOOST_TEST(t.count_node() == nodes);
+	BOOST_TEST(t.find(bad) == t.end());
+	BOOST_TEST(t.count_prefix(k1) == 1);
+}
+
+void cursor_test()
+{
+	tmci t;
+	BOOST_TEST(t.begin_cursor().at_end());
+	std::string words[] = { "to", "tea", "ted", "ten", "i", "in", "inn", "a" };
+	for (int i = 0; i < 8; ++i)
+		t[words[i]] = i;
+	tmci::cursor c = t.begin_cursor();
+	ti it = t.begin();
+	size_t n = 0;
+	for (; !c.at_end(); ++c, ++it, ++n)
+	{
+		BOOST_TEST(c.key() == it.get_key());
+		BOOST_TEST(c.value() == (*it).second);
+	}
+	BOOST_TEST(it == t.end());
+	BOOST_TEST(n == t.size());
+	++c;
+	BOOST_TEST(c.at_end());
+
+	c = t.begin_cursor();
+	c.value() = 42;
+	BOOST_TEST(t[std::string("a")] == 42);
+	const tmci& ct = t;
+	tmci::const_cursor cc = ct.begin_cursor();
+	BOOST_TEST(cc.value() == 42);
+	BOOST_TEST(std::string(cc.key().begin(), cc.key().end()) == "a");
+}
+
+void batch_test()
+{
+	tmci t;
+	std::vector<std::string> keys;
+	for (int i = 0; i < 100; ++i)
+	{
+		std::string k(1 + i % 5, static_cast<char>('a' + i % 3));
+		k += static_cast<char>('0' + i % 10);
+		t[k] = i;
+		keys.push_back(k);
+		// missing, a bare prefix and a longer miss
+		keys.push_back(k + "x");
+		keys.push_back(k.substr(0, k.size() - 1));
+	}
+	keys.push_back(std::string());
+	std::vector<ti> found;
+	std::vector<size_t> counts;
+	t.find_batch(keys.begin(), keys.end(), std::back_inserter(found));
+	t.count_batch(keys.begin(), keys.end(), std::back_inserter(counts));
+	BOOST_TEST(found.size() == keys.size());
+	BOOST_TEST(counts.size() == keys.size());
+	for (size_t i = 0; i < keys.size() && i < found.size(); ++i)
+	{
+		BOOST_TEST(found[i] == t.find(keys[i]));
+		BOOST_TEST(counts[i] == t.count(keys[i]));
+	}
+}
+
+void sorted_batch_test()
+{
+	tmci t;
+	std::vector<std::string> keys;
+	for (int i = 0; i < 300; ++i)
+	{
+		std::string w;
+		int len = rand() % 6 + 1;
+		for (int j = 0; j < len; ++j)
+			w += static_cast<char>('a' + rand() % 3);
+		if (i % 2 == 0)
+			t[w] = i;
+		keys.push_back(w);
+		keys.push_back(w.substr(0, w.size() / 2));
+	}
+	for (int pass = 0; pass < 2; ++pass)
+	{
+		// sorted the second time; the results do not depend on the order
+		if (pass == 1)
+			std::sort(keys.begin(), keys.end());
+		std::vector<ti> found;
+		std::vector<size_t> counts;
+		t.find_sorted_batch(keys.begin(), keys.end(), std::back_inserter(found));
+		t.count_prefix_sorted_batch(keys.begin(), keys.end(), std::back_inserter(counts));
+		BOOST_TEST(found.size() == keys.size());
+		BOOST_TEST(counts.size() == keys.size());
+		for (size_t i = 0; i < keys.size() && i < found.size(); ++i)
+		{
+			BOOST_TEST(found[i] == t.find(keys[i]));
+			BOOST_TEST(counts[i] == t.count_prefix(keys[i]));
+		}
+	}
+}
+
+void longest_prefix_match_test()
+{
+	tmci t;
+	t[std::string("10")] = 1;
+	t[std::string("10.1")] = 2;
+	t[std::string("10.1.2")] = 3;
+	t[std::string("11")] = 4;
+	std::pair<ti, size_t> m = t.longest_prefix_match(std::string("10.1.2.7"));
+	BOOST_TEST(m.first == t.find(std::string("10.1.2")));
+	BOOST_TEST(m.second == 6);
+	m = t.longest_prefix_match(std::string("10.1.3"));
+	BOOST_TEST((*m.first).second == 2);
+	BOOST_TEST(m.second == 4);
+	m = t.longest_prefix_match(std::string("10.1"));
+	BOOST_TEST((*m.first).second == 2);
+	BOOST_TEST(m.second == 4);
+	m = t.longest_prefix_match(std::string("1"));
+	BOOST_TEST(m.first == t.end());
+	BOOST_TEST(m.second == 0);
+	m = t.longest_prefix_match(std::string("2"));
+	BOOST_TEST(m.first == t.end());
+}
+
+void prefixes_of_test()
+{
+	tmci t;
+	t[std::string("/")] = 1;
+	t[std::string("/api")] = 2;
+	t[std::string("/api/v1")] = 3;
+	t[std::string("/apix")] = 4;
+	std::vector<ti> found;
+	t.prefixes_of(std::string("/api/v1/users"), std::back_inserter(found));
+	BOOST_TEST(found.size() == 3);
+	for (size_t i = 0; i < found.size(); ++i)
+		BOOST_TEST((*found[i]).second == int(i) + 1);
+	found.clear();
+	t.prefixes_of(std::string("/ap"), std::back_inserter(found));
+	BOOST_TEST(found.size() == 1);
+	found.clear();
+	t.prefixes_of(std::string("x/api"), std::back_inserter(found));
+	BOOST_TEST(found.empty());
+}
+
+void fuzzy_find_test()
+{
+	tmci t;
+	t[std::string("color")] = 1;
+	t[std::string("colour")] = 2;
+	t[std::string("collar")] = 3;
+	t[std::string("cooler")] = 4;
+	std::vector<std::pair<ti, size_t> > found;
+	t.fuzzy_find(std::string("colr"), 1, std::back_inserter(found));
+	BOOST_TEST(found.size() == 1);
+	BOOST_TEST((*found[0].first).second == 1);
+	found.clear();
+	t.fuzzy_find(std::string("colr"), 2, std::back_inserter(found));
+	// collar, color, colour, cooler
+	BOOST_TEST(found.size() == 4);
+	BOOST_TEST((*found[0].first).second == 3 && found[0].second == 2);
+	BOOST_TEST((*found[2].first).second == 2 && found[2].second == 2);
+	found.clear();
+	t.fuzzy_find(std::string(""), 4, std::back_inserter(found));
+	BOOST_TEST(found.empty());
+}
+
+void match_pattern_test()
+{
+	tmci t;
+	t[std::string("log/2024-01-02")] = 1;
+	t[std::string("log/2024-01-12")] = 2;
+	t[std::string("log/2024-02-02")] = 3;
+	t[std::string("log/2025-01-02")] = 4;
+	std::vector<ti> found;
+	t.match_pattern(std::string("log/2024-01-?2"), std::back_inserter(found));
+	BOOST_TEST(found.size() == 2);
+	BOOST_TEST((*found[0]).second == 1);
+	BOOST_TEST((*found[1]).second == 2);
+	found.clear();
+	t.match_pattern(std::string("log/202[45]-0[1]-02"), std::back_inserter(found));
+	BOOST_TEST(found.size() == 2);
+	BOOST_TEST((*found[1]).second == 4);
+	found.clear();
+	t.match_pattern(std::string("log/2024-01-02"), std::back_inserter(found));
+	BOOST_TEST(found.size() == 1);
+	found.clear();
+	t.match_pattern(std::string("log/2024"), std::back_inserter(found));
+	BOOST_TEST(found.empty());
+}
+
+// the pages of size n of the prefix range cover it in order
+void iterator_range_test_helper(tmci& t, const std::string& prefix, size_t n)
+{
+	std::pair<ti, ti> all = t.find_prefix(prefix);
+	ti cur = all.first;
+	for (size_t offset = 0; ; offset += n)
+	{
+		std::pair<ti, ti> page = t.find_prefix(prefix, offset, n);
+		BOOST_TEST(page.first == cur);
+		if (page.first == page.second)
+			break;
+		for (; cur != page.second; ++cur)
+			BOOST_TEST(cur != all.second);
+	}
+	BOOST_TEST(cur == all.second);
+}
+
+void order_statistics_test()
+{
+	tmci t;
+	std::map<std::string, int> m;
+	for (int i = 0; i < 500; ++i)
+	{
+		std::string w;
+		int len = rand() % 5 + 1;
+		for (int j = 0; j < len; ++j)
+			w += static_cast<char>('a' + rand() % 4);
+		t[w] = i;
+		m[w] = i;
+	}
+	std::vector<std::string> keys;
+	for (std::map<std::string, int>::iterator it = m.begin(); it != m.end(); ++it)
+		keys.push_back(it->first);
+	ti it = t.begin();
+	for (size_t i = 0; i < keys.size(); ++i, ++it)
+	{
+		BOOST_TEST(t.rank(keys[i]) == i);
+		BOOST_TEST(t.select(i) == it);
+		BOOST_TEST(t.position(it) == i);
+	}
+	BOOST_TEST(t.select(keys.size()) == t.end());
+	BOOST_TEST(t.position(t.end()) == t.size());
+	BOOST_TEST(t.rank(std::string("zz")) == t.size());
+	BOOST_TEST(t.rank(std::string("")) == 0);
+	// keys that are not there count what comes before them
+	BOOST_TEST(t.rank(std::string("bbbbbb")) ==
+		size_t(std::distance(m.begin(), m.lower_bound("bbbbbb"))));
+	BOOST_TEST(t.rank(std::string("c")) ==
+		size_t(std::distance(m.begin(), m.lower_bound("c"))));
+
+	BOOST_TEST(t.advance(t.begin(), 10) == t.select(10));
+	BOOST_TEST(t.advance(t.select(10), -4) == t.select(6));
+	BOOST_TEST(t.advance(t.select(3), -10) == t.begin());
+	BOOST_TEST(t.advance(t.begin(), t.size() + 5) == t.end());
+
+	// pages of a prefix range
+	iterator_range_test_helper(t, std::string("b"), 7);
+	iterator_range_test_helper(t, std::string("ca"), 3);
+	std::pair<ti, ti> page = t.find_prefix(std::string("x"), 0, 5);
+	BOOST_TEST(page.first == t.end() && page.second == t.end());
+}
+
+void count_range_test()
+{
+	tmci t;
+	std::map<std::string, int> m;
+	for (int i = 0; i < 400; ++i)
+	{
+		std::string w;
+		int len = rand() % 4 + 1;
+		for (int j = 0; j < len; ++j)
+			w += static_cast<char>('0' + rand() % 5);
+		t[w] = i;
+		m[w] = i;
+	}
+	for (int i = 0; i < 100; ++i)
+	{
+		std::string lo(1, static_cast<char>('0' + rand() % 5));
+		std::string hi = lo;
+		lo += static_cast<char>('0' + rand() % 5);
+		hi += static_cast<char>('0' + rand() % 5);
+		hi += static_cast<char>('0' + rand() % 5);
+		size_t expected = 0;
+		if (lo < hi)
+			expected = std::distance(m.lower_bound(lo), m.lower_bound(hi));
+		BOOST_TEST(t.count_range(lo, hi) == expected);
+	}
+	BOOST_TEST(t.count_range(std::string("0"), std::string("5")) == m.size());
+	BOOST_TEST(t.count_range(std::string("3"), std::string("3")) == 0);
+	BOOST_TEST(t.count_range(std::string("4"), std::string("1")) == 0);
+}
+
+void prefix_cursor_test()
+{
+	tmci t;
+	t[std::string("car")] = 1;
+	t[std::string("cart")] = 2;
+	t[std::string("cat")] = 3;
+	t[std::string("dog")] = 4;
+	tmci::prefix_cursor c = t.begin_prefix_cursor();
+	BOOST_TEST(c.count() == 4);
+	BOOST_TEST(c.range().first == t.begin() && c.range().second == t.end());
+	BOOST_TEST(c.extend('c'));
+	BOOST_TEST(c.extend('a'));
+	BOOST_TEST(c.count() == 3);
+	BOOST_TEST(!c.has_value());
+	tmci::prefix_cursor saved = c;
+	BOOST_TEST(c.extend('r'));
+	BOOST_TEST(c.has_value());
+	BOOST_TEST(c.count() == 2);
+	std::pair<ti, ti> r = c.range();
+	BOOST_TEST((*r.first).second == 1);
+	BOOST_TEST(r.second == t.find(std::string("cat")));
+	BOOST_TEST(r == t.find_prefix(std::string("car")));
+	// typing past the keys and back
+	BOOST_TEST(!c.extend('x'));
+	BOOST_TEST(!c.extend('t'));
+	BOOST_TEST(!c.valid());
+	BOOST_TEST(c.count() == 0);
+	BOOST_TEST(c.range().first == c.range().second);
+	c.retract();
+	c.retract();
+	BOOST_TEST(c.has_value() && c.length() == 3);
+	c.retract();
+	BOOST_TEST(c.count() == saved.count() && c.node() == saved.node());
+	BOOST_TEST(saved.extend('t') && saved.has_value());
+	c.retract();
+	c.retract();
+	c.retract();
+	BOOST_TEST(c.length() == 0 && c.count() == 4);
+}
+
+void hinted_insert_test()
+{
+	tmci t, plain;
+	std::vector<std::string> keys;
+	for (int i = 0; i < 500; ++i)
+	{
+		std::string w = "2024-";
+		int len = rand() % 4 + 1;
+		for (int j = 0; j < len; ++j)
+			w += static_cast<char>('0' + rand() % 4);
+		keys.push_back(w);
+	}
+	// sorted input with the previous result as hint, then random hints
+	std::vector<std::string> sorted(keys);
+	std::sort(sorted.begin(), sorted.end());
+	ti hint = t.end();
+	for (size_t i = 0; i < sorted.size(); ++i)
+	{
+		hint = t.insert(hint, sorted[i], int(i));
+		BOOST_TEST(hint == t.find(sorted[i]));
+		plain.insert(sorted[i], int(i));
+	}
+	BOOST_TEST(t.size() == plain.size());
+	BOOST_TEST(t.count_node() == plain.count_node());
+	for (size_t i = 0; i < keys.size(); ++i)
+	{
+		ti h = t.select(rand() % t.size());
+		std::string k = keys[i] + "x";
+		ti it = t.insert(h, k, -1);
+		BOOST_TEST(it == t.find(k));
+		// a key that is there keeps its value
+		BOOST_TEST(t.insert(h, keys[i], -2) == t.find(keys[i]));
+		BOOST_TEST((*t.find(keys[i])).second != -2);
+	}
+	BOOST_TEST(t.size() == plain.size() * 2);
+	ti first = t.insert(t.find(sorted[0]), std::string("1999"), 7);
+	BOOST_TEST(first == t.begin());
+	BOOST_TEST((*t.begin()).second == 7);
+
+	// hints deeper than the part of their path that is followed
+	tmci deep;
+	std::string long_key(100, 'a');
+	ti h = deep.insert(deep.end(), long_key, 1);
+	for (int i = 0; i < 10; ++i)
+	{
+		std::string k = long_key;
+		k[30 + i * 7] = 'b';
+		h = deep.insert(h, k, i);
+		BOOST_TEST(h == deep.find(k));
+	}
+	h = deep.insert(h, long_key + "c", 2);
+	BOOST_TEST(h == deep.find(long_key + "c"));
+	BOOST_TEST(deep.size() == 12);
+	BOOST_TEST(deep.count_prefix(long_key) == 2);
+}
+
 int main() {
 	operator_test();
 	insert_and_find_test();
@@ -449,5 +999,23 @@ int main() {
 	find_prefix();
 	get_key_test();
 	get_key_reverse_test();
+	wide_fanout_test();
+	fanout_bound_test();
+	cursor_test();
+	batch_test();
+	sorted_batch_test();
+	longest_prefix_match_test();
+	prefixes_of_test();
+	fuzzy_find_test();
+	match_pattern_test();
+	order_statistics_test();
+	count_range_test();
+	prefix_cursor_test();
+	hinted_insert_test();
+	child_policy_test<boost::tries::adaptive_children_policy>();
+	child_policy_test<boost::tries::rbtree_children_policy>();
+	child_policy_test<boost::tries::vector_children_policy>();
+	child_policy_test<boost::tries::indexed_children_policy<> >();
+	indexed_int_key_test();
 	return boost::report_errors();
 }
@@ -5,6 +5,9 @@
 #include "boost/trie/trie.hpp"
 
 #include <string>
+#include <vector>
+#include <iterator>
+#include <stdexcept>
 
 typedef boost::tries::trie_multimap<char, int> tci;
 typedef tci::iterator iter_type;
@@ -44,6 +47,218 @@ void insert_and_find_test()
 	BOOST_TEST(t.count_prefix(std::string("aab")) == 2);
 }
 
+// enough values on one key to leave the inline storage
+void many_values_test()
+{
+	tci t;
+	std::string s = "ab", s2 = "b";
+	for (int i = 0; i < 20; ++i)
+		t.insert(s, i);
+	t.insert(s2, 100);
+	BOOST_TEST(t.count(s) == 20);
+	BOOST_TEST(t.size() == 21);
+
+	// newest first, both ways
+	iter_type it = t.begin();
+	for (int i = 19; i >= 0; --i, ++it)
+		BOOST_TEST((*it).second == i);
+	BOOST_TEST((*it).second == 100);
+	for (int i = 0; i < 20; ++i)
+	{
+		--it;
+		BOOST_TEST((*it).second == i);
+	}
+	BOOST_TEST(it == t.begin());
+
+	tci::iterator_range r = t.equal_range(s);
+	int n = 0;
+	for (; r.first != r.second; ++r.first)
+		++n;
+	BOOST_TEST(n == 20);
+	BOOST_TEST((*r.second).second == 100);
+
+	tci t2(t);
+	BOOST_TEST(t2.count(s) == 20);
+	BOOST_TEST((*t2.begin()).second == 19);
+
+	// erase returns the next value, the older ones do not move
+	it = t.begin();
+	++it;
+	it = t.erase(it);
+	BOOST_TEST((*it).second == 17);
+	while ((*it).second != 100)
+		it = t.erase(it);
+	BOOST_TEST(t.count(s) == 1);
+	BOOST_TEST((*t.begin()).second == 19);
+	t.erase(t.begin());
+	BOOST_TEST(t.count(s) == 0);
+	BOOST_TEST(t.size() == 1);
+	BOOST_TEST(t.count_node() == 1);
+}
+
+// a value whose copy throws once the countdown runs out, counting the live ones
+struct fragile_value {
+	static int live;
+	static int copies_left;
+	std::string text;
+
+	explicit fragile_value(int i) : text(std::string(40, 'v') + char('a' + i % 26))
+	{
+		++live;
+	}
+
+	fragile_value(const fragile_value& other) : text(other.text)
+	{
+		if (copies_left >= 0 && copies_left-- == 0)
+			throw std::runtime_error("copy failed");
+		++live;
+	}
+
+	~fragile_value()
+	{
+		--live;
+	}
+};
+
+int fragile_value::live = 0;
+int fragile_value::copies_left = -1;
+
+void throwing_value_test()
+{
+	typedef boost::tries::trie_multimap<char, fragile_value> fragile_map;
+	{
+		fragile_map t;
+		std::string s = "k";
+		std::vector<std::string> kept;
+		for (int i = 0; i < 40; ++i)
+		{
+			// only an insert moving the values to a bigger block copies more than once
+			fragile_value::copies_left = 2;
+			try {
+				t.insert(s, fragile_value(i));
+				kept.push_back(fragile_value(i).text);
+			} catch (const std::runtime_error&) {
+			}
+			fragile_value::copies_left = -1;
+			BOOST_TEST(fragile_value::live == int(t.size()));
+		}
+		BOOST_TEST(t.count(s) == kept.size());
+		BOOST_TEST(kept.size() < 40);
+		// newest first
+		fragile_map::iterator it = t.begin();
+		for (size_t i = kept.size(); i > 0; --i, ++it)
+			BOOST_TEST((*it).second.text == kept[i - 1]);
+
+		// erasing never throws, even when shrinking the block cannot copy
+		fragile_value::copies_left = 0;
+		while (!t.empty())
+			t.erase(t.begin());
+		fragile_value::copies_left = -1;
+		BOOST_TEST(t.count_node() == 0);
+	}
+	BOOST_TEST(fragile_value::live == 0);
+}
+
+void prefixes_of_test()
+{
+	tci t;
+	t.insert(std::string("a"), 1);
+	t.insert(std::string("a"), 2);
+	t.insert(std::string("abc"), 3);
+	t.insert(std::string("abd"), 4);
+	std::vector<iter_type> found;
+	t.prefixes_of(std::string("abcd"), std::back_inserter(found));
+	BOOST_TEST(found.size() == 3);
+	if (found.size() == 3)
+	{
+		BOOST_TEST((*found[0]).second == 2);
+		BOOST_TEST((*found[1]).second == 1);
+		BOOST_TEST((*found[2]).second == 3);
+	}
+}
+
+void cursor_test()
+{
+	tci t;
+	std::string s = "ab", s2 = "abc", s3 = "b";
+	for (int i = 0; i < 6; ++i)
+		t.insert(s, i);
+	t.insert(s2, 10);
+	t.insert(s3, 20);
+	t.insert(s3, 21);
+	tci::cursor c = t.begin_cursor();
+	iter_type it = t.begin();
+	size_t n = 0;
+	for (; !c.at_end(); ++c, ++it, ++n)
+	{
+		BOOST_TEST(c.key() == it.get_key());
+		BOOST_TEST(c.value() == (*it).second);
+	}
+	BOOST_TEST(n == t.size());
+	BOOST_TEST(it == t.end());
+}
+
+void order_statistics_test()
+{
+	tci t;
+	t.insert(std::string("ab"), 1);
+	t.insert(std::string("ab"), 2);
+	t.insert(std::string("a"), 3);
+	t.insert(std::string("b"), 4);
+	t.insert(std::string("ab"), 5);
+	// a:3, ab:5 2 1, b:4
+	BOOST_TEST(t.rank(std::string("ab")) == 1);
+	BOOST_TEST(t.rank(std::string("b")) == 4);
+	BOOST_TEST(t.rank(std::string("abc")) == 4);
+	int expected[] = { 3, 5, 2, 1, 4 };
+	iter_type it = t.begin();
+	for (size_t i = 0; i < 5; ++i, ++it)
+	{
+		BOOST_TEST(t.select(i) == it);
+		BOOST_TEST((*t.select(i)).second == expected[i]);
+		BOOST_TEST(t.position(it) == i);
+	}
+	BOOST_TEST(t.select(5) == t.end());
+	BOOST_TEST(t.advance(t.select(1), 2) == t.select(3));
+	std::pair<iter_type, iter_type> page = t.find_prefix(std::string("ab"), 1, 1);
+	BOOST_TEST((*page.first).second == 2);
+	BOOST_TEST(page.second == t.select(3));
+}
+
+void find_prefix_test()
+{
+	tci t;
+	for (int i = 0; i < 1000; ++i)
+		t.insert(std::string("ab"), i);
+	t.insert(std::string("a"), -1);
+	t.insert(std::string("b"), -2);
+	std::pair<iter_type, iter_type> r = t.find_prefix(std::string("a"));
+	BOOST_TEST((*r.first).second == -1);
+	BOOST_TEST(r.second == t.find(std::string("b")));
+	BOOST_TEST(std::distance(r.first, r.second) == 1001);
+	r = t.find_prefix(std::string("b"));
+	BOOST_TEST(r.second == t.end());
+	r = t.find_prefix(std::string("ab"));
+	BOOST_TEST((*r.first).second == 999);
+	BOOST_TEST(std::distance(r.first, r.second) == 1000);
+	r = t.find_prefix(std::string("c"));
+	BOOST_TEST(r.first == t.end() && r.second == t.end());
+}
+
+void hinted_insert_test()
+{
+	tci t;
+	iter_type hint = t.end();
+	hint = t.insert(hint, std::string("ab"), 1);
+	hint = t.insert(hint, std::string("ab"), 2);
+	hint = t.insert(hint, std::string("abc"), 3);
+	hint = t.insert(hint, std::string("b"), 4);
+	BOOST_TEST((*hint).second == 4);
+	BOOST_TEST(t.size() == 4);
+	BOOST_TEST(t.count(std::string("ab")) == 2);
+	BOOST_TEST((*t.find(std::string("ab"))).second == 2);
+}
+
 /*
 void copy_test()
 {
@@ -292,6 +507,13 @@ void get_key_test()
 int main() {
 	operator_test();
 	insert_and_find_test();
+	many_values_test();
+	cursor_test();
+	prefixes_of_test();
+	order_statistics_test();
+	find_prefix_test();
+	hinted_insert_test();
+	throwing_value_test();
 	/*
 	copy_test();
 	iterator_operator_plus();
@@ -205,6 +205,67 @@ void reverse_iterator_test()
 	}
 	BOOST_TEST(count == a.size());
 }
+
+// duplicates are only counted, each one is still visited
+void counter_test()
+{
+	tmsi a;
+	std::string the = "the", cat = "cat";
+	for (int i = 0; i < 100000; ++i)
+		a.insert(the);
+	a.insert(cat);
+	a.insert(cat);
+	BOOST_TEST(a.count(the) == 100000);
+	BOOST_TEST(a.size() == 100002);
+	BOOST_TEST(a.count_prefix(std::string("th")) == 100000);
+	BOOST_TEST(a.count_node() == 6);
+
+	size_t count = 0;
+	tmsi::iterator_range r = a.equal_range(the);
+	for (; r.first != r.second; ++r.first)
+		++count;
+	BOOST_TEST(count == 100000);
+
+	count = 0;
+	for (rti ri = a.rbegin(); ri != a.rend(); ++ri)
+		++count;
+	BOOST_TEST(count == a.size());
+
+	// erasing one occurrence keeps the key
+	a.erase(a.begin());
+	BOOST_TEST(a.count(cat) == 1);
+	a.erase(a.begin());
+	BOOST_TEST(a.count(cat) == 0);
+	BOOST_TEST(a.count_node() == 3);
+	BOOST_TEST(a.erase(the) == 100000);
+	BOOST_TEST(a.empty());
+
+	tmsi b;
+	b.insert(the);
+	b.insert(the);
+	tmsi c(b);
+	BOOST_TEST(c.count(the) == 2);
+}
+void order_statistics_test()
+{
+	tmsi t;
+	t.insert(std::string("b"));
+	t.insert(std::string("a"));
+	t.insert(std::string("a"));
+	t.insert(std::string("c"));
+	BOOST_TEST(t.rank(std::string("b")) == 2);
+	BOOST_TEST(t.rank(std::string("c")) == 3);
+	BOOST_TEST(t.select(1) == ++t.begin());
+	BOOST_TEST(t.select(2) == t.find(std::string("b")));
+	BOOST_TEST(t.position(t.find(std::string("c"))) == 3);
+	BOOST_TEST(t.advance(t.begin(), 3) == t.find(std::string("c")));
+	BOOST_TEST(t.count_range(std::string("a"), std::string("c")) == 3);
+	ti hint = t.insert(t.find(std::string("b")), std::string("ba"));
+	hint = t.insert(hint, std::string("ba"));
+	BOOST_TEST(t.count(std::string("ba")) == 2);
+	BOOST_TEST(t.size() == 6);
+}
+
 /*
 void insert_and_find_test()
 {
@@ -476,6 +537,8 @@ int main() {
 	erase_test();
 	equal_range_test();
 	reverse_iterator_test();
+	counter_test();
+	order_statistics_test();
 	/*
 	insert_and_find_test();
 	copy_test();
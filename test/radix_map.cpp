@@ -0,0 +1,236 @@
+#include <boost/core/lightweight_test.hpp>
+#include "boost/trie/radix_trie_map.hpp"
+//multi include test
+#include "boost/trie/radix_trie_map.hpp"
+#include "boost/trie/radix_trie.hpp"
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <map>
+
+typedef boost::tries::radix_trie_map<char, int> rmci;
+typedef rmci::iterator ri;
+
+std::string key_string(ri it)
+{
+	std::vector<char> k = (*it).first;
+	return std::string(k.begin(), k.end());
+}
+
+void operator_test()
+{
+	rmci t;
+	std::string s = "aaa", s2 = "bbb";
+	t[s] = 1;
+	BOOST_TEST(t[s] == 1);
+	t[s] = 2;
+	BOOST_TEST(t[s] == 2);
+	t[s2] = t[s];
+	BOOST_TEST(t[s] == t[s2]);
+	BOOST_TEST(t.size() == 2);
+}
+
+void split_merge_test()
+{
+	rmci t;
+	std::string romane = "romane", romanus = "romanus", romulus = "romulus",
+		rubens = "rubens", ruber = "ruber", rubicon = "rubicon", rubicundus = "rubicundus";
+	t.insert(romane, 1);
+	BOOST_TEST(t.count_node() == 1);
+	t.insert(romanus, 2);
+	// "roman" + "e", "us"
+	BOOST_TEST(t.count_node() == 3);
+	t.insert(romulus, 3);
+	t.insert(rubens, 4);
+	t.insert(ruber, 5);
+	t.insert(rubicon, 6);
+	t.insert(rubicundus, 7);
+	// r, om, an, e, us, ulus, ub, e, ns, r, ic, on, undus
+	BOOST_TEST(t.count_node() == 13);
+	BOOST_TEST(t.size() == 7);
+	BOOST_TEST(t.count_prefix(std::string("rom")) == 3);
+	BOOST_TEST(t.count_prefix(std::string("rubi")) == 2);
+	BOOST_TEST(t.count_prefix(std::string("rubicu")) == 1);
+	BOOST_TEST(t.count_prefix(std::string("rubx")) == 0);
+	BOOST_TEST(t.find(std::string("rub")) == t.end());
+	BOOST_TEST(t.find(std::string("rubico")) == t.end());
+	BOOST_TEST((*t.find(rubicon)).second == 6);
+
+	// a key ending inside an edge splits it
+	t.insert(std::string("rubic"), 8);
+	BOOST_TEST(t.count_node() == 13);
+	t.insert(std::string("rubico"), 9);
+	BOOST_TEST(t.count_node() == 14);
+	BOOST_TEST((*t.find(std::string("rubico"))).second == 9);
+	BOOST_TEST(t.erase(std::string("rubico")) == t.find(rubicon));
+	BOOST_TEST(t.count_node() == 13);
+	t.erase(std::string("rubic"));
+
+	// erasing merges the single child chains back
+	t.erase(romanus);
+	BOOST_TEST(t.count_node() == 11);
+	BOOST_TEST((*t.find(romane)).second == 1);
+	t.erase(ruber);
+	BOOST_TEST(t.count_node() == 9);
+	BOOST_TEST((*t.find(rubens)).second == 4);
+	t.erase_prefix(std::string("rubi"));
+	// r, om, ane, ulus, ubens
+	BOOST_TEST(t.count_node() == 5);
+	t.erase(romulus);
+	BOOST_TEST(t.count_node() == 3);
+	t.erase(romane);
+	BOOST_TEST(t.count_node() == 1);
+	BOOST_TEST(key_string(t.begin()) == rubens);
+	t.clear();
+	BOOST_TEST(t.empty());
+	BOOST_TEST(t.count_node() == 0);
+}
+
+void iterator_test()
+{
+	rmci t;
+	std::string s1 = "abc", s2 = "abcdef", s3 = "abd", s4 = "b";
+	t.insert(s3, 3);
+	t.insert(s1, 1);
+	t.insert(s4, 4);
+	t.insert(s2, 2);
+	ri it = t.begin();
+	BOOST_TEST(key_string(it) == s1);
+	BOOST_TEST(key_string(++it) == s2);
+	BOOST_TEST(key_string(++it) == s3);
+	BOOST_TEST(key_string(++it) == s4);
+	BOOST_TEST(++it == t.end());
+	BOOST_TEST(key_string(--it) == s4);
+	BOOST_TEST(key_string(--it) == s3);
+	BOOST_TEST(key_string(--it) == s2);
+	BOOST_TEST(key_string(--it) == s1);
+	BOOST_TEST(it == t.begin());
+
+	rmci::reverse_iterator rit = t.rbegin();
+	BOOST_TEST((*rit).second == 4);
+	++rit;
+	BOOST_TEST((*rit).second == 3);
+
+	rmci::iterator_range r = t.find_prefix(std::string("abc"));
+	BOOST_TEST(r.first == t.find(s1));
+	BOOST_TEST(r.second == t.find(s3));
+	r = t.find_prefix(std::string("abcd"));
+	BOOST_TEST(r.first == t.find(s2));
+	BOOST_TEST(r.second == t.find(s3));
+	r = t.find_prefix(std::string("b"));
+	BOOST_TEST(r.first == t.find(s4));
+	BOOST_TEST(r.second == t.end());
+	r = t.find_prefix(std::string("abx"));
+	BOOST_TEST(r.first == t.end());
+
+	BOOST_TEST(t.lower_bound(std::string("abcd")) == t.find(s2));
+	BOOST_TEST(t.lower_bound(std::string("abcz")) == t.find(s3));
+	BOOST_TEST(t.lower_bound(std::string("abce")) == t.find(s3));
+	BOOST_TEST(t.lower_bound(std::string("a")) == t.find(s1));
+	BOOST_TEST(t.lower_bound(std::string("c")) == t.end());
+	BOOST_TEST(t.upper_bound(s1) == t.find(s2));
+	BOOST_TEST(t.upper_bound(s4) == t.end());
+}
+
+void copy_test()
+{
+	rmci t1;
+	t1[std::string("abcd")] = 1;
+	t1[std::string("abef")] = 2;
+	t1[std::string("xyz")] = 3;
+	rmci t2(t1), t3;
+	t3 = t1;
+	BOOST_TEST(t2.count_node() == t1.count_node());
+	BOOST_TEST(t3.count_node() == t1.count_node());
+	BOOST_TEST(t2.size() == 3);
+	BOOST_TEST((*t3.find(std::string("abef"))).second == 2);
+	BOOST_TEST(t2.count_prefix(std::string("ab")) == 2);
+	t1.clear();
+	BOOST_TEST((*t2.find(std::string("xyz"))).second == 3);
+}
+
+// labels longer than fit in a node, split and merged across that size
+void long_label_test()
+{
+	rmci t;
+	std::string base(40, 'x'), a = base + "a", b = base.substr(0, 10) + "b",
+		c = base.substr(0, 30) + "c";
+	t[a] = 1;
+	BOOST_TEST(t.count_node() == 1);
+	t[b] = 2;
+	t[c] = 3;
+	// x*10, b, x*20, c, x*10 + a
+	BOOST_TEST(t.count_node() == 5);
+	BOOST_TEST(t.count_prefix(base.substr(0, 25)) == 2);
+	BOOST_TEST(t.find(base) == t.end());
+	BOOST_TEST(key_string(t.find(a)) == a);
+	rmci t2(t);
+	BOOST_TEST(key_string(t2.find(c)) == c);
+	// merging the edges back builds the label of a again
+	t.erase(b);
+	BOOST_TEST(t.count_node() == 3);
+	t.erase(c);
+	BOOST_TEST(t.count_node() == 1);
+	BOOST_TEST(key_string(t.begin()) == a);
+	BOOST_TEST(t2.size() == 3);
+	BOOST_TEST((*t2.find(b)).second == 2);
+	BOOST_TEST(t.erase(a) == t.end());
+	BOOST_TEST(t.count_node() == 0);
+}
+
+// compare against std::map on keys with long shared runs
+void random_test()
+{
+	rmci t;
+	std::map<std::string, int> m;
+	std::srand(12345);
+	for (int i = 0; i < 2000; ++i)
+	{
+		std::string k(1 + std::rand() % 12, 'a');
+		for (size_t j = 0; j < k.size(); ++j)
+			if (std::rand() % 4 == 0)
+				k[j] = 'a' + std::rand() % 3;
+		if (std::rand() % 3 == 0)
+		{
+			BOOST_TEST(t.count(k) == m.erase(k));
+			t.erase(k);
+		} else {
+			BOOST_TEST(t.insert(k, i).second == m.insert(std::make_pair(k, i)).second);
+		}
+	}
+	BOOST_TEST(t.size() == m.size());
+	ri it = t.begin();
+	for (std::map<std::string, int>::iterator mi = m.begin(); mi != m.end(); ++mi, ++it)
+	{
+		BOOST_TEST(key_string(it) == mi->first);
+		BOOST_TEST((*it).second == mi->second);
+	}
+	BOOST_TEST(it == t.end());
+	for (int i = 0; i < 200; ++i)
+	{
+		std::string k(1 + std::rand() % 12, 'a');
+		for (size_t j = 0; j < k.size(); ++j)
+			k[j] = 'a' + std::rand() % 3;
+		std::map<std::string, int>::iterator mi = m.lower_bound(k);
+		ri li = t.lower_bound(k);
+		BOOST_TEST(mi == m.end() ? li == t.end() : key_string(li) == mi->first);
+		mi = m.upper_bound(k);
+		li = t.upper_bound(k);
+		BOOST_TEST(mi == m.end() ? li == t.end() : key_string(li) == mi->first);
+	}
+	for (std::map<std::string, int>::iterator mi = m.begin(); mi != m.end(); ++mi)
+		t.erase(mi->first);
+	BOOST_TEST(t.empty());
+	BOOST_TEST(t.count_node() == 0);
+}
+
+int main() {
+	operator_test();
+	split_merge_test();
+	iterator_test();
+	copy_test();
+	long_label_test();
+	random_test();
+	return boost::report_errors();
+}
@@ -0,0 +1,157 @@
+#include <boost/core/lightweight_test.hpp>
+#include "boost/trie/radix_trie_set.hpp"
+// multi include test
+#include "boost/trie/radix_trie_set.hpp"
+#include "boost/trie/radix_trie.hpp"
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+typedef boost::tries::radix_trie_set<char> rsci;
+
+void insert_erase_test()
+{
+	rsci t;
+	std::string s = "aaa", s2 = "bbb";
+	BOOST_TEST(t.empty());
+	BOOST_TEST(t.begin() == t.end());
+	BOOST_TEST(t.rbegin() == t.rend());
+	BOOST_TEST(t.insert(s).second == true);
+	BOOST_TEST(t.insert(s).second == false);
+	BOOST_TEST(t.erase(s) == t.end());
+	BOOST_TEST(t.count_node() == 0);
+	BOOST_TEST(t.insert(s).second == true);
+	BOOST_TEST(t.insert(s2).second == true);
+	BOOST_TEST(t.insert(s2).second == false);
+	BOOST_TEST(t.erase(s2) == t.end());
+	BOOST_TEST(t.insert(s2).second == true);
+	BOOST_TEST(t.count_node() == 2);
+}
+
+void prefix_test()
+{
+	rsci t;
+	std::string s1 = "aaa", s2 = "bbb", s3 = "aaaa", s4 = "aaab";
+	t.insert(s1);
+	t.insert(s2);
+	t.insert(s3);
+	t.insert(s4);
+	BOOST_TEST(t.count_node() == 4);
+	std::vector<char> v = *(t.find(s4));
+	BOOST_TEST(std::string(v.begin(), v.end()) == s4);
+	BOOST_TEST(t.count_prefix(std::string("a")) == 3);
+	BOOST_TEST(t.count_prefix(std::string("aa")) == 3);
+	BOOST_TEST(t.count_prefix(std::string("bb")) == 1);
+	BOOST_TEST(t.erase_prefix(std::string("aa")) == 3);
+	BOOST_TEST(t.count_node() == 1);
+	BOOST_TEST(t.size() == 1);
+	BOOST_TEST(t.erase_prefix(std::string("c")) == 0);
+}
+
+void int_key_test()
+{
+	typedef boost::tries::radix_trie_set<int, boost::tries::vector_children_policy> int_set;
+	int_set t;
+	std::vector<int> k1, k2, k3;
+	for (int i = 0; i < 10; ++i)
+		k1.push_back(i * 100);
+	k2 = k1;
+	k2[7] = -1;
+	k3.assign(k1.begin(), k1.begin() + 5);
+	t.insert(k1);
+	t.insert(k2);
+	t.insert(k3);
+	BOOST_TEST(t.count_node() == 4);
+	int_set::iterator it = t.begin();
+	BOOST_TEST(*it == k3);
+	BOOST_TEST(*++it == k2);
+	BOOST_TEST(*++it == k1);
+	BOOST_TEST(++it == t.end());
+	t.erase(k3);
+	BOOST_TEST(t.count_node() == 3);
+	t.erase(k2);
+	BOOST_TEST(t.count_node() == 1);
+	BOOST_TEST(*t.begin() == k1);
+}
+
+// a key element whose copy throws once the countdown runs out, counting the live ones
+struct fragile_key {
+	static int live;
+	static int copies_left;
+	std::string text;
+
+	explicit fragile_key(char c = 'a') : text(std::string(40, 'k') + c)
+	{
+		++live;
+	}
+
+	fragile_key(const fragile_key& other) : text(other.text)
+	{
+		if (copies_left >= 0 && copies_left-- == 0)
+			throw std::runtime_error("copy failed");
+		++live;
+	}
+
+	fragile_key& operator=(const fragile_key& other)
+	{
+		text = other.text;
+		return *this;
+	}
+
+	~fragile_key()
+	{
+		--live;
+	}
+
+	bool operator<(const fragile_key& other) const
+	{
+		return text < other.text;
+	}
+
+	bool operator==(const fragile_key& other) const
+	{
+		return text == other.text;
+	}
+};
+
+int fragile_key::live = 0;
+int fragile_key::copies_left = -1;
+
+void throwing_key_test()
+{
+	typedef boost::tries::radix_trie_set<fragile_key,
+		boost::tries::rbtree_children_policy> fragile_set;
+	{
+		fragile_set t;
+		std::vector<fragile_key> k1(6), k2(3);
+		k2.push_back(fragile_key('b'));
+		k2.push_back(fragile_key('b'));
+		// k2 first, so that the label of k1 below the split is exactly full
+		t.insert(k2);
+		t.insert(k1);
+		BOOST_TEST(t.count_node() == 3);
+		// erasing k2 merges the edges of k1 back, which copies its elements
+		// into a bigger label; a failed copy leaves the edges apart
+		fragile_key::copies_left = 1;
+		BOOST_TEST_THROWS(t.erase(k2), std::runtime_error);
+		fragile_key::copies_left = -1;
+		BOOST_TEST(t.size() == 1);
+		BOOST_TEST(t.find(k1) != t.end());
+		BOOST_TEST(t.find(k2) == t.end());
+		BOOST_TEST(*t.begin() == k1);
+		t.insert(k2);
+		BOOST_TEST(t.size() == 2);
+		t.erase(k2);
+		BOOST_TEST(*t.begin() == k1);
+	}
+	BOOST_TEST(fragile_key::live == 0);
+}
+
+int main() {
+	insert_erase_test();
+	prefix_test();
+	int_key_test();
+	throwing_key_test();
+	return boost::report_errors();
+}
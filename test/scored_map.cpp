@@ -0,0 +1,122 @@
+#include <boost/core/lightweight_test.hpp>
+#include "boost/trie/scored_trie_map.hpp"
+// multi include test
+#include "boost/trie/scored_trie_map.hpp"
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <iterator>
+
+typedef boost::tries::scored_trie_map<char, int> stmci;
+typedef stmci::const_iterator tci;
+
+std::string key_of(tci it)
+{
+	std::vector<char> key = it.get_key();
+	return std::string(key.begin(), key.end());
+}
+
+void top_k_test()
+{
+	stmci t;
+	t.insert(std::string("car"), 5);
+	t.insert(std::string("cart"), 9);
+	t.insert(std::string("care"), 2);
+	t.insert(std::string("cat"), 7);
+	t.insert(std::string("dog"), 10);
+	BOOST_TEST(t.size() == 5);
+	BOOST_TEST(!t.insert(std::string("cat"), 1).second);
+	BOOST_TEST((*t.find(std::string("cat"))).second.score == 7);
+
+	std::vector<tci> found;
+	t.top_k(std::string("ca"), 3, std::back_inserter(found));
+	BOOST_TEST(found.size() == 3);
+	BOOST_TEST(key_of(found[0]) == "cart");
+	BOOST_TEST(key_of(found[1]) == "cat");
+	BOOST_TEST(key_of(found[2]) == "car");
+	found.clear();
+	t.top_k(std::string(""), 10, std::back_inserter(found));
+	BOOST_TEST(found.size() == 5);
+	BOOST_TEST(key_of(found[0]) == "dog");
+	found.clear();
+	t.top_k(std::string("x"), 3, std::back_inserter(found));
+	BOOST_TEST(found.empty());
+
+	// a lower score takes the key down, a higher one up
+	t.set_score(std::string("cart"), 1);
+	found.clear();
+	t.top_k(std::string("car"), 1, std::back_inserter(found));
+	BOOST_TEST(key_of(found[0]) == "car");
+	t.set_score(std::string("care"), 20);
+	found.clear();
+	t.top_k(std::string(""), 1, std::back_inserter(found));
+	BOOST_TEST(key_of(found[0]) == "care");
+
+	t.erase(std::string("care"));
+	found.clear();
+	t.top_k(std::string("car"), 2, std::back_inserter(found));
+	BOOST_TEST(found.size() == 2);
+	BOOST_TEST(key_of(found[0]) == "car");
+	BOOST_TEST(key_of(found[1]) == "cart");
+
+	stmci c(t);
+	found.clear();
+	c.top_k(std::string("c"), 1, std::back_inserter(found));
+	BOOST_TEST(key_of(found[0]) == "cat");
+}
+
+// scores ordered highest first, keys after that for a stable comparison
+bool score_greater(const std::pair<int, std::string>& a, const std::pair<int, std::string>& b)
+{
+	return a.first > b.first;
+}
+
+void random_test()
+{
+	stmci t;
+	std::map<std::string, int> m;
+	for (int i = 0; i < 3000; ++i)
+	{
+		std::string w;
+		int len = rand() % 5 + 1;
+		for (int j = 0; j < len; ++j)
+			w += static_cast<char>('a' + rand() % 4);
+		int op = rand() % 4;
+		int score = rand() % 1000 - 500;
+		if (op == 0)
+		{
+			t.erase(w);
+			m.erase(w);
+		}
+		else
+		{
+			t.set_score(w, score);
+			m[w] = score;
+		}
+		if (i % 50 != 0)
+			continue;
+		std::string prefix(1, static_cast<char>('a' + rand() % 4));
+		size_t k = rand() % 8 + 1;
+		std::vector<std::pair<int, std::string> > expected;
+		for (std::map<std::string, int>::iterator it = m.begin(); it != m.end(); ++it)
+			if (it->first.compare(0, 1, prefix) == 0)
+				expected.push_back(std::make_pair(it->second, it->first));
+		std::stable_sort(expected.begin(), expected.end(), score_greater);
+		std::vector<tci> found;
+		t.top_k(prefix, k, std::back_inserter(found));
+		BOOST_TEST(found.size() == std::min(k, expected.size()));
+		for (size_t j = 0; j < found.size() && j < expected.size(); ++j)
+			BOOST_TEST((*found[j]).second.score == expected[j].first);
+	}
+	BOOST_TEST(t.size() == m.size());
+}
+
+int main()
+{
+	top_k_test();
+	random_test();
+	return boost::report_errors();
+}
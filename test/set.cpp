@@ -5,6 +5,11 @@
 #include "boost/trie/trie.hpp"
 
 #include <string>
+#include <vector>
+#include <iterator>
+#include <cstdlib>
+#include <algorithm>
+#include <stdexcept>
 
 typedef boost::tries::trie_set<char> tsci;
 typedef tsci::iterator ti;
@@ -217,6 +222,319 @@ void upper_bound_test() {
 	BOOST_TEST(t.upper_bound(std::string("bbcccd")) == t.find(std::string("bbd")));
 }
 
+void wide_fanout_test()
+{
+	typedef boost::tries::trie_set<int> int_set;
+	int_set t;
+	std::vector<int> k(2);
+	for (int i = 0; i < 100; ++i)
+	{
+		k[0] = (i * 7) % 100;
+		k[1] = i % 3;
+		BOOST_TEST(t.insert(k).second == true);
+	}
+	BOOST_TEST(t.size() == 100);
+	int prev = -1;
+	for (int_set::iterator i = t.begin(); i != t.end(); ++i)
+	{
+		BOOST_TEST((*i)[0] > prev);
+		prev = (*i)[0];
+	}
+	for (int i = 0; i < 100; i += 2)
+	{
+		k[0] = i;
+		BOOST_TEST(t.erase_prefix(k.begin(), k.begin() + 1) == 1);
+	}
+	BOOST_TEST(t.size() == 50);
+	for (int i = 0; i < 100; ++i)
+	{
+		k[0] = i;
+		BOOST_TEST(t.count_prefix(k.begin(), k.begin() + 1) == size_t(i % 2));
+	}
+	k[0] = 50;
+	k[1] = 0;
+	BOOST_TEST((*t.lower_bound(k))[0] == 51);
+	t.clear();
+	BOOST_TEST(t.empty());
+}
+
+struct dna_index {
+	static const std::size_t size = 4;
+
+	std::size_t operator () (char c) const
+	{
+		switch (c) {
+		case 'A': return 0;
+		case 'C': return 1;
+		case 'G': return 2;
+		case 'T': return 3;
+		default: return size;
+		}
+	}
+};
+
+void indexed_children_test()
+{
+	typedef boost::tries::trie_set<char,
+		boost::tries::indexed_children_policy<dna_index> > dna_set;
+	dna_set t;
+	std::string s1 = "ACGT", s2 = "ACG", s3 = "TTA", s4 = "GATTACA";
+	t.insert(s1);
+	t.insert(s2);
+	t.insert(s3);
+	t.insert(s4);
+	BOOST_TEST(t.size() == 4);
+	BOOST_TEST(t.find(s1) != t.end());
+	BOOST_TEST(t.find(std::string("ACGN")) == t.end());
+	size_t nodes = t.count_node();
+	BOOST_TEST_THROWS(t.insert(std::string("ACGN")), std::out_of_range);
+	BOOST_TEST_THROWS(t.insert(std::string("NA")), std::out_of_range);
+	BOOST_TEST(t.size() == 4);
+	BOOST_TEST(t.count_node() == nodes);
+	BOOST_TEST(t.count_prefix(std::string("AC")) == 2);
+	dna_set::iterator i = t.begin();
+	BOOST_TEST(*i == std::vector<char>(s2.begin(), s2.end()));
+	++i;
+	BOOST_TEST(*i == std::vector<char>(s1.begin(), s1.end()));
+	++i;
+	BOOST_TEST(*i == std::vector<char>(s4.begin(), s4.end()));
+	++i;
+	BOOST_TEST(*i == std::vector<char>(s3.begin(), s3.end()));
+	++i;
+	BOOST_TEST(i == t.end());
+	BOOST_TEST(t.lower_bound(std::string("C")) == t.find(s4));
+	BOOST_TEST(t.upper_bound(s1) == t.find(s4));
+	t.erase(s4);
+	BOOST_TEST(t.lower_bound(std::string("C")) == t.find(s3));
+}
+
+void cursor_test()
+{
+	tsci t;
+	std::string words[] = { "b", "ab", "abc", "a" };
+	for (int i = 0; i < 4; ++i)
+		t.insert(words[i]);
+	tsci::cursor c = t.begin_cursor();
+	ti it = t.begin();
+	for (; !c.at_end(); ++c, ++it)
+		BOOST_TEST(c.key() == *it);
+	BOOST_TEST(it == t.end());
+}
+
+void longest_prefix_match_test()
+{
+	tsci t;
+	t.insert(std::string("/usr"));
+	t.insert(std::string("/usr/local"));
+	std::pair<ti, size_t> m = t.longest_prefix_match(std::string("/usr/local/bin"));
+	BOOST_TEST(m.second == 10);
+	BOOST_TEST(m.first == t.find(std::string("/usr/local")));
+	m = t.longest_prefix_match(std::string("/usr/lib"));
+	BOOST_TEST(m.second == 4);
+	m = t.longest_prefix_match(std::string("/opt"));
+	BOOST_TEST(m.first == t.end());
+}
+
+size_t edit_distance(const std::string& a, const std::string& b)
+{
+	std::vector<size_t> row(b.size() + 1);
+	for (size_t j = 0; j <= b.size(); ++j)
+		row[j] = j;
+	for (size_t i = 1; i <= a.size(); ++i)
+	{
+		size_t diag = row[0];
+		row[0] = i;
+		for (size_t j = 1; j <= b.size(); ++j)
+		{
+			size_t up = row[j];
+			row[j] = std::min(std::min(row[j], row[j - 1]) + 1,
+				diag + (a[i - 1] == b[j - 1] ? 0 : 1));
+			diag = up;
+		}
+	}
+	return row[b.size()];
+}
+
+void fuzzy_find_test()
+{
+	tsci t;
+	std::string words[] = { "cat", "cart", "care", "dog", "cut", "at", "scat" };
+	for (int i = 0; i < 7; ++i)
+		t.insert(words[i]);
+	std::vector<std::pair<ti, size_t> > found;
+	t.fuzzy_find(std::string("cat"), 1, std::back_inserter(found));
+	// in key order: at, cart, cat, cut, scat
+	BOOST_TEST(found.size() == 5);
+	BOOST_TEST(found[0].first == t.find(std::string("at")) && found[0].second == 1);
+	BOOST_TEST(found[2].first == t.find(std::string("cat")) && found[2].second == 0);
+	BOOST_TEST(found[4].first == t.find(std::string("scat")) && found[4].second == 1);
+	found.clear();
+	t.fuzzy_find(std::string("cat"), 0, std::back_inserter(found));
+	BOOST_TEST(found.size() == 1);
+
+	// against the distance to every key
+	for (int round = 0; round < 10; ++round)
+	{
+		tsci r;
+		std::vector<std::string> keys;
+		for (int i = 0; i < 200; ++i)
+		{
+			std::string w;
+			int len = rand() % 6 + 1;
+			for (int j = 0; j < len; ++j)
+				w += static_cast<char>('a' + rand() % 4);
+			r.insert(w);
+		}
+		for (ti it = r.begin(); it != r.end(); ++it)
+		{
+			std::vector<char> key = *it;
+			keys.push_back(std::string(key.begin(), key.end()));
+		}
+		std::string query;
+		int len = rand() % 6;
+		for (int j = 0; j < len; ++j)
+			query += static_cast<char>('a' + rand() % 4);
+		size_t bound = rand() % 3;
+		found.clear();
+		r.fuzzy_find(query, bound, std::back_inserter(found));
+		size_t k = 0;
+		for (size_t i = 0; i < keys.size(); ++i)
+		{
+			size_t d = edit_distance(keys[i], query);
+			if (d > bound)
+				continue;
+			BOOST_TEST(k < found.size() && found[k].second == d);
+			if (k < found.size())
+			{
+				std::vector<char> key = *found[k].first;
+				BOOST_TEST(std::string(key.begin(), key.end()) == keys[i]);
+			}
+			++k;
+		}
+		BOOST_TEST(k == found.size());
+	}
+}
+
+// reference glob matching for '?', '*' and simple classes without ranges
+bool glob_match(const std::string& pat, size_t p, const std::string& s, size_t i)
+{
+	if (p == pat.size())
+		return i == s.size();
+	if (pat[p] == '*')
+		return glob_match(pat, p + 1, s, i) || (i < s.size() && glob_match(pat, p, s, i + 1));
+	if (i == s.size())
+		return false;
+	if (pat[p] == '[')
+	{
+		size_t close = pat.find(']', p + 1);
+		bool negate = pat[p + 1] == '!';
+		bool in = pat.substr(p + 1 + negate, close - p - 1 - negate).find(s[i]) != std::string::npos;
+		return in != negate && glob_match(pat, close + 1, s, i + 1);
+	}
+	return (pat[p] == '?' || pat[p] == s[i]) && glob_match(pat, p + 1, s, i + 1);
+}
+
+void match_pattern_test()
+{
+	tsci t;
+	std::string words[] = { "api/a/v1/users", "api/b/v2/users/x", "api/a/v10/users",
+		"api/users", "apix/a/v1/users", "b" };
+	for (int i = 0; i < 6; ++i)
+		t.insert(words[i]);
+	std::vector<ti> found;
+	t.match_pattern(std::string("api/*/v?/users*"), std::back_inserter(found));
+	BOOST_TEST(found.size() == 2);
+	BOOST_TEST(found[0] == t.find(std::string("api/a/v1/users")));
+	BOOST_TEST(found[1] == t.find(std::string("api/b/v2/users/x")));
+	found.clear();
+	t.match_pattern(std::string("*"), std::back_inserter(found));
+	BOOST_TEST(found.size() == 6);
+	found.clear();
+	t.match_pattern(std::string("api/[a-c]/v[!2]*"), std::back_inserter(found));
+	BOOST_TEST(found.size() == 2);
+	found.clear();
+	t.match_pattern(std::string("[b"), std::back_inserter(found));
+	BOOST_TEST(found.empty());
+	found.clear();
+	// an escaped element is literal
+	t.match_pattern(std::string("\\b"), std::back_inserter(found));
+	BOOST_TEST(found.size() == 1);
+	found.clear();
+	t.match_pattern(std::string("\\?"), std::back_inserter(found));
+	BOOST_TEST(found.empty());
+
+	std::string patterns[] = { "a*b", "*a?", "[ab]*c", "?[!a]*", "**", "c?a*", "*ab*ba*" };
+	tsci r;
+	std::vector<std::string> keys;
+	for (int i = 0; i < 300; ++i)
+	{
+		std::string w;
+		int len = rand() % 6 + 1;
+		for (int j = 0; j < len; ++j)
+			w += static_cast<char>('a' + rand() % 3);
+		r.insert(w);
+	}
+	for (ti it = r.begin(); it != r.end(); ++it)
+	{
+		std::vector<char> key = *it;
+		keys.push_back(std::string(key.begin(), key.end()));
+	}
+	for (int p = 0; p < 7; ++p)
+	{
+		found.clear();
+		r.match_pattern(patterns[p], std::back_inserter(found));
+		std::vector<ti> expected;
+		for (size_t i = 0; i < keys.size(); ++i)
+			if (glob_match(patterns[p], 0, keys[i], 0))
+				expected.push_back(r.find(keys[i]));
+		BOOST_TEST(found == expected);
+	}
+}
+
+void order_statistics_test()
+{
+	tsci t;
+	std::string words[] = { "d", "b", "ba", "a", "c" };
+	for (int i = 0; i < 5; ++i)
+		t.insert(words[i]);
+	BOOST_TEST(t.rank(std::string("ba")) == 2);
+	BOOST_TEST(t.select(2) == t.find(std::string("ba")));
+	BOOST_TEST(t.position(t.find(std::string("c"))) == 3);
+	BOOST_TEST(t.advance(t.find(std::string("d")), -4) == t.begin());
+	BOOST_TEST(t.count_range(std::string("b"), std::string("c")) == 2);
+	BOOST_TEST(t.count_range(std::string("b"), std::string("cc")) == 3);
+	std::pair<tci, tci> page = t.find_prefix(std::string(""), 1, 3);
+	BOOST_TEST(page.first == t.find(std::string("b")));
+	BOOST_TEST(page.second == t.find(std::string("d")));
+}
+
+void prefix_cursor_test()
+{
+	tsci t;
+	t.insert(std::string("ab"));
+	t.insert(std::string("abc"));
+	tsci::prefix_cursor c = t.begin_prefix_cursor();
+	BOOST_TEST(c.extend('a') && c.extend('b'));
+	BOOST_TEST(c.has_value());
+	BOOST_TEST(c.count() == 2);
+	BOOST_TEST(c.range().first == t.begin());
+	BOOST_TEST(c.range().second == t.end());
+}
+
+void hinted_insert_test()
+{
+	tsci t;
+	ti hint = t.end();
+	std::string words[] = { "a", "ab", "abc", "abd", "b", "ab" };
+	for (int i = 0; i < 6; ++i)
+	{
+		hint = t.insert(hint, words[i]);
+		BOOST_TEST(hint == t.find(words[i]));
+	}
+	BOOST_TEST(t.size() == 5);
+	BOOST_TEST(t.count_node() == 5);
+}
+
 int main() {
 	insert_erase_test();
 	insert_find_test();
@@ -225,5 +543,14 @@ int main() {
 	iterator_operator_minus();
 	lower_bound_test();
 	upper_bound_test();
+	wide_fanout_test();
+	indexed_children_test();
+	cursor_test();
+	longest_prefix_match_test();
+	fuzzy_find_test();
+	match_pattern_test();
+	order_statistics_test();
+	prefix_cursor_test();
+	hinted_insert_test();
 	return boost::report_errors();
 }